@@ -0,0 +1,264 @@
+/*
+ * Storage concurrency tester
+ *
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "system_config.h"
+
+#include "OS_Error.h"
+#include "OS_Dataport.h"
+#include "interfaces/if_OS_Storage.h"
+#include "TimeServer.h"
+#include "SysLoggerClient.h"
+#include "lib_compiler/compiler.h"
+#include "lib_debug/Debug.h"
+
+#include <camkes.h>
+
+#include <assert.h>
+#include <inttypes.h>
+#include <string.h>
+
+#define WORKER_PATTERN  0x3C
+
+typedef struct
+{
+    const if_OS_Storage_t*  storage;
+    int                     (*regCallback)(void (*)(void*), void*);
+    void                    (*go)(void);
+    off_t                   storageSize;
+    size_t                  requestSize;
+    OS_Error_t              err;
+} Worker_t;
+
+static const if_OS_Timer_t timer =
+    IF_OS_TIMER_ASSIGN(
+        timeServer_rpc,
+        timeServer_notify);
+
+static const if_OS_Storage_t storages[] =
+{
+    IF_OS_STORAGE_ASSIGN(worker0_rpc, worker0_port),
+    IF_OS_STORAGE_ASSIGN(worker1_rpc, worker1_port),
+    IF_OS_STORAGE_ASSIGN(worker2_rpc, worker2_port),
+    IF_OS_STORAGE_ASSIGN(worker3_rpc, worker3_port),
+};
+
+static Worker_t workers[] =
+{
+    { &storages[0], worker0_start_reg_callback, worker0_go_emit },
+    { &storages[1], worker1_start_reg_callback, worker1_go_emit },
+    { &storages[2], worker2_start_reg_callback, worker2_go_emit },
+    { &storages[3], worker3_start_reg_callback, worker3_go_emit },
+};
+
+static_assert(
+    ARRAY_SIZE(workers) == CONCURRENCY_BENCH_NUM_WORKERS,
+    "Number of workers does not match StorageConcurrencyTester.camkes");
+
+
+//------------------------------------------------------------------------------
+static uint64_t
+getTimeUs(void)
+{
+    uint64_t now = 0;
+
+    const OS_Error_t err = TimeServer_getTime(
+                               &timer,
+                               TimeServer_PRECISION_USEC,
+                               &now);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("TimeServer_getTime() failed with %d", err);
+    }
+
+    return now;
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+runWorkload(
+    Worker_t* worker)
+{
+    const off_t numSlots = worker->storageSize / worker->requestSize;
+
+    // Writes first and then reads, so every worker alternates between both
+    // in the same way.
+    for (unsigned int i = 0; i < (2 * CONCURRENCY_BENCH_REQUESTS); i++)
+    {
+        const off_t offset = (i % numSlots) * worker->requestSize;
+        size_t processed = 0;
+        OS_Error_t err;
+
+        if (i < CONCURRENCY_BENCH_REQUESTS)
+        {
+            err = worker->storage->write(
+                      offset, worker->requestSize, &processed);
+        }
+        else
+        {
+            err = worker->storage->read(
+                      offset, worker->requestSize, &processed);
+        }
+
+        if (OS_SUCCESS != err)
+        {
+            return err;
+        }
+        if (processed != worker->requestSize)
+        {
+            return OS_ERROR_GENERIC;
+        }
+    }
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+static void
+workerStart(
+    void* ctx)
+{
+    Worker_t* worker = ctx;
+
+    worker->err = runWorkload(worker);
+
+    // The callback fires only once, so it must be registered again before we
+    // report completion and the next round can start.
+    DECL_UNUSED_VAR(int rc) = worker->regCallback(workerStart, worker);
+    Debug_ASSERT(0 == rc);
+
+    workers_done_post();
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+runRound(
+    size_t    numWorkers,
+    uint64_t* elapsedUs)
+{
+    const uint64_t startUs = getTimeUs();
+
+    for (size_t i = 0; i < numWorkers; i++)
+    {
+        workers[i].go();
+    }
+
+    for (size_t i = 0; i < numWorkers; i++)
+    {
+        workers_done_wait();
+    }
+
+    *elapsedUs = getTimeUs() - startUs;
+
+    for (size_t i = 0; i < numWorkers; i++)
+    {
+        if (OS_SUCCESS != workers[i].err)
+        {
+            Debug_LOG_ERROR("Worker %zu failed with %d", i, workers[i].err);
+            return workers[i].err;
+        }
+    }
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+void
+post_init(void)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(workers); i++)
+    {
+        DECL_UNUSED_VAR(int rc) = workers[i].regCallback(
+                                      workerStart,
+                                      &workers[i]);
+        Debug_ASSERT(0 == rc);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+int
+run()
+{
+    DECL_UNUSED_VAR(OS_Error_t err) = SysLoggerClient_init(sysLogger_Rpc_log);
+    Debug_ASSERT(err == OS_SUCCESS);
+
+    for (size_t i = 0; i < ARRAY_SIZE(workers); i++)
+    {
+        Worker_t* worker = &workers[i];
+
+        if ((err = worker->storage->getSize(&worker->storageSize))
+            != OS_SUCCESS)
+        {
+            Debug_LOG_ERROR("getSize() of worker %zu failed with %d", i, err);
+            return -1;
+        }
+
+        worker->requestSize = OS_Dataport_getSize(worker->storage->dataport);
+        if (worker->storageSize < (off_t)worker->requestSize)
+        {
+            Debug_LOG_ERROR(
+                "Storage of worker %zu is smaller than its dataport", i);
+            return -1;
+        }
+
+        memset(
+            OS_Dataport_getBuf(worker->storage->dataport),
+            WORKER_PATTERN,
+            worker->requestSize);
+    }
+
+    uint64_t singleKiBPerSec = 0;
+
+    for (size_t numWorkers = 1; numWorkers <= ARRAY_SIZE(workers); numWorkers++)
+    {
+        uint64_t elapsedUs = 0;
+
+        if ((err = runRound(numWorkers, &elapsedUs)) != OS_SUCCESS)
+        {
+            Debug_LOG_ERROR(
+                "%s -> !!! Round with %zu workers failed.",
+                get_instance_name(),
+                numWorkers);
+            return -1;
+        }
+
+        const uint64_t numRequests = numWorkers * 2 * CONCURRENCY_BENCH_REQUESTS;
+        const uint64_t bytes       = numRequests * workers[0].requestSize;
+        const uint64_t kibPerSec   = (elapsedUs > 0)
+                                     ? ((bytes * 1000000) / 1024) / elapsedUs
+                                     : 0;
+        if (1 == numWorkers)
+        {
+            singleKiBPerSec = kibPerSec;
+        }
+
+        Debug_LOG_INFO(
+            "%s: %zu workers: %" PRIu64 " requests in %" PRIu64 " us, "
+            "%" PRIu64 " KiB/s, speedup %" PRIu64 ".%02" PRIu64,
+            get_instance_name(),
+            numWorkers,
+            numRequests,
+            elapsedUs,
+            kibPerSec,
+            (singleKiBPerSec > 0) ? kibPerSec / singleKiBPerSec : 0,
+            (singleKiBPerSec > 0)
+                ? ((kibPerSec * 100) / singleKiBPerSec) % 100 : 0);
+    }
+
+    Debug_LOG_INFO(
+        "%s -> !!! All benchmarks successfully completed.",
+        get_instance_name());
+
+    return 0;
+}
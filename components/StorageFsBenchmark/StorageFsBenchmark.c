@@ -0,0 +1,532 @@
+/*
+ * Filesystem benchmark
+ *
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "system_config.h"
+
+#include "OS_FileSystem.h"
+#include "StorageStats.h"
+#include "TimeServer.h"
+#include "SysLoggerClient.h"
+#include "lib_compiler/compiler.h"
+#include "lib_debug/Debug.h"
+
+#include <camkes.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+// Block-level storage RPCs issued by the filesystem.
+typedef struct
+{
+    uint64_t numWrites;
+    uint64_t numReads;
+    uint64_t numErases;
+    uint64_t numOthers;
+    uint64_t bytesWritten;
+    uint64_t bytesRead;
+    uint64_t bytesErased;
+} RpcCounters_t;
+
+typedef struct
+{
+    const char*         fsName;
+    const char*         name;
+    uint64_t            startUs;
+    uint64_t            appBytes;
+    RpcCounters_t       startRpcs;
+} Phase_t;
+
+static const if_OS_Timer_t timer =
+    IF_OS_TIMER_ASSIGN(
+        timeServer_rpc,
+        timeServer_notify);
+
+static RpcCounters_t rpcs;
+
+static const OS_Dataport_t statsPort = OS_DATAPORT_ASSIGN(stats_port);
+
+static uint8_t chunk[FS_BENCH_STREAM_CHUNK_SIZE];
+
+
+//------------------------------------------------------------------------------
+// Counting wrappers around the storage RPCs, so we see what the filesystem
+// does on the block level.
+//------------------------------------------------------------------------------
+
+static OS_Error_t
+countingWrite(
+    off_t   offset,
+    size_t  size,
+    size_t* written)
+{
+    const OS_Error_t err = storage_rpc_write(offset, size, written);
+    rpcs.numWrites++;
+    rpcs.bytesWritten += *written;
+    return err;
+}
+
+static OS_Error_t
+countingRead(
+    off_t   offset,
+    size_t  size,
+    size_t* read)
+{
+    const OS_Error_t err = storage_rpc_read(offset, size, read);
+    rpcs.numReads++;
+    rpcs.bytesRead += *read;
+    return err;
+}
+
+static OS_Error_t
+countingErase(
+    off_t  offset,
+    off_t  size,
+    off_t* erased)
+{
+    const OS_Error_t err = storage_rpc_erase(offset, size, erased);
+    rpcs.numErases++;
+    rpcs.bytesErased += (*erased > 0) ? *erased : 0;
+    return err;
+}
+
+static OS_Error_t
+countingGetSize(
+    off_t* const size)
+{
+    rpcs.numOthers++;
+    return storage_rpc_getSize(size);
+}
+
+static OS_Error_t
+countingGetBlockSize(
+    size_t* const blockSize)
+{
+    rpcs.numOthers++;
+    return storage_rpc_getBlockSize(blockSize);
+}
+
+static OS_Error_t
+countingGetState(
+    uint32_t* flags)
+{
+    rpcs.numOthers++;
+    return storage_rpc_getState(flags);
+}
+
+static const if_OS_Storage_t countingStorage =
+{
+    .write          = countingWrite,
+    .read           = countingRead,
+    .erase          = countingErase,
+    .getSize        = countingGetSize,
+    .getBlockSize   = countingGetBlockSize,
+    .getState       = countingGetState,
+    .dataport       = OS_DATAPORT_ASSIGN(storage_port)
+};
+
+
+//------------------------------------------------------------------------------
+static uint64_t
+getTimeUs(void)
+{
+    uint64_t now = 0;
+
+    const OS_Error_t err = TimeServer_getTime(
+                               &timer,
+                               TimeServer_PRECISION_USEC,
+                               &now);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("TimeServer_getTime() failed with %d", err);
+    }
+
+    return now;
+}
+
+
+//------------------------------------------------------------------------------
+static void
+phaseStart(
+    Phase_t*    phase,
+    const char* fsName,
+    const char* name)
+{
+    phase->fsName    = fsName;
+    phase->name      = name;
+    phase->appBytes  = 0;
+    phase->startRpcs = rpcs;
+
+    const OS_Error_t err = stats_rpc_reset();
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("stats_rpc_reset() failed with %d", err);
+    }
+
+    phase->startUs   = getTimeUs();
+}
+
+
+//------------------------------------------------------------------------------
+static void
+phaseEnd(
+    const Phase_t* phase,
+    uint64_t       numOps)
+{
+    const uint64_t elapsedUs = getTimeUs() - phase->startUs;
+
+    StorageStats_t backend;
+    memset(&backend, 0, sizeof(backend));
+
+    const OS_Error_t err = stats_rpc_get();
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("stats_rpc_get() failed with %d", err);
+    }
+    else
+    {
+        memcpy(&backend, OS_Dataport_getBuf(statsPort), sizeof(backend));
+    }
+
+    const RpcCounters_t d =
+    {
+        .numWrites    = rpcs.numWrites    - phase->startRpcs.numWrites,
+        .numReads     = rpcs.numReads     - phase->startRpcs.numReads,
+        .numErases    = rpcs.numErases    - phase->startRpcs.numErases,
+        .numOthers    = rpcs.numOthers    - phase->startRpcs.numOthers,
+        .bytesWritten = rpcs.bytesWritten - phase->startRpcs.bytesWritten,
+        .bytesRead    = rpcs.bytesRead    - phase->startRpcs.bytesRead,
+        .bytesErased  = rpcs.bytesErased  - phase->startRpcs.bytesErased,
+    };
+
+    Debug_LOG_INFO(
+        "%s [%s] %s: %" PRIu64 " ops in %" PRIu64 " us, %" PRIu64 " ops/s, "
+        "rpcs w/r/e/other=%" PRIu64 "/%" PRIu64 "/%" PRIu64 "/%" PRIu64 ", "
+        "bytes w/r/e=%" PRIu64 "/%" PRIu64 "/%" PRIu64,
+        get_instance_name(),
+        phase->fsName,
+        phase->name,
+        numOps,
+        elapsedUs,
+        (elapsedUs > 0) ? (numOps * 1000000) / elapsedUs : 0,
+        d.numWrites, d.numReads, d.numErases, d.numOthers,
+        d.bytesWritten, d.bytesRead, d.bytesErased);
+
+    Debug_LOG_INFO(
+        "%s [%s] %s: backend ops w/r/e=%" PRIu64 "/%" PRIu64 "/%" PRIu64 ", "
+        "bytes w/r/e=%" PRIu64 "/%" PRIu64 "/%" PRIu64 ", "
+        "busy %" PRIu64 " us, max latency %" PRIu64 " us",
+        get_instance_name(),
+        phase->fsName,
+        phase->name,
+        backend.numWrites, backend.numReads, backend.numErases,
+        backend.bytesWritten, backend.bytesRead, backend.bytesErased,
+        backend.busyUs, backend.maxLatencyUs);
+
+    if (phase->appBytes > 0)
+    {
+        // Write amplification in percent, 100 means no amplification.
+        Debug_LOG_INFO(
+            "%s [%s] %s: application wrote %" PRIu64 " bytes, "
+            "write amplification %" PRIu64 "%% (backend %" PRIu64 "%%)",
+            get_instance_name(),
+            phase->fsName,
+            phase->name,
+            phase->appBytes,
+            (d.bytesWritten * 100) / phase->appBytes,
+            (backend.bytesWritten * 100) / phase->appBytes);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+appendToFile(
+    OS_FileSystem_Handle_t hFs,
+    const char*            name,
+    off_t                  offset,
+    const void*            data,
+    size_t                 len)
+{
+    OS_FileSystemFile_Handle_t hFile;
+
+    OS_Error_t err = OS_FileSystemFile_open(
+                         hFs,
+                         &hFile,
+                         name,
+                         OS_FileSystem_OpenMode_RDWR,
+                         OS_FileSystem_OpenFlags_CREATE);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("OS_FileSystemFile_open() failed with %d", err);
+        return err;
+    }
+
+    err = OS_FileSystemFile_write(hFs, hFile, offset, len, data);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("OS_FileSystemFile_write() failed with %d", err);
+    }
+
+    // There is no explicit fsync, closing the file flushes it to the storage.
+    const OS_Error_t errClose = OS_FileSystemFile_close(hFs, hFile);
+    if (OS_SUCCESS != errClose)
+    {
+        Debug_LOG_ERROR("OS_FileSystemFile_close() failed with %d", errClose);
+        return errClose;
+    }
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+runMetadataWorkload(
+    OS_FileSystem_Handle_t hFs,
+    const char*            fsName)
+{
+    OS_Error_t err;
+    Phase_t phase;
+    char name[16];
+
+    memset(chunk, 'm', FS_BENCH_APPEND_SIZE);
+
+    phaseStart(&phase, fsName, "create");
+    for (unsigned int i = 0; i < FS_BENCH_NUM_FILES; i++)
+    {
+        snprintf(name, sizeof(name), "f%03u.dat", i);
+        if ((err = appendToFile(hFs, name, 0, chunk, 0)) != OS_SUCCESS)
+        {
+            return err;
+        }
+    }
+    phaseEnd(&phase, FS_BENCH_NUM_FILES);
+
+    phaseStart(&phase, fsName, "append+fsync");
+    for (unsigned int a = 0; a < FS_BENCH_APPENDS_PER_FILE; a++)
+    {
+        for (unsigned int i = 0; i < FS_BENCH_NUM_FILES; i++)
+        {
+            snprintf(name, sizeof(name), "f%03u.dat", i);
+            err = appendToFile(
+                      hFs,
+                      name,
+                      a * FS_BENCH_APPEND_SIZE,
+                      chunk,
+                      FS_BENCH_APPEND_SIZE);
+            if (OS_SUCCESS != err)
+            {
+                return err;
+            }
+            phase.appBytes += FS_BENCH_APPEND_SIZE;
+        }
+    }
+    phaseEnd(&phase, FS_BENCH_APPENDS_PER_FILE * FS_BENCH_NUM_FILES);
+
+    phaseStart(&phase, fsName, "delete");
+    for (unsigned int i = 0; i < FS_BENCH_NUM_FILES; i++)
+    {
+        snprintf(name, sizeof(name), "f%03u.dat", i);
+        if ((err = OS_FileSystemFile_delete(hFs, name)) != OS_SUCCESS)
+        {
+            Debug_LOG_ERROR("OS_FileSystemFile_delete() failed with %d", err);
+            return err;
+        }
+    }
+    phaseEnd(&phase, FS_BENCH_NUM_FILES);
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+runStreamingWorkload(
+    OS_FileSystem_Handle_t hFs,
+    const char*            fsName)
+{
+    static const char* const name = "stream.dat";
+    static const size_t numChunks =
+        FS_BENCH_STREAM_SIZE / FS_BENCH_STREAM_CHUNK_SIZE;
+
+    OS_FileSystemFile_Handle_t hFile;
+    OS_Error_t err;
+    OS_Error_t errClose;
+    Phase_t phase;
+
+    memset(chunk, 's', sizeof(chunk));
+
+    phaseStart(&phase, fsName, "stream write");
+    err = OS_FileSystemFile_open(
+              hFs,
+              &hFile,
+              name,
+              OS_FileSystem_OpenMode_RDWR,
+              OS_FileSystem_OpenFlags_CREATE);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("OS_FileSystemFile_open() failed with %d", err);
+        return err;
+    }
+    for (size_t i = 0; (i < numChunks) && (OS_SUCCESS == err); i++)
+    {
+        err = OS_FileSystemFile_write(
+                  hFs,
+                  hFile,
+                  i * sizeof(chunk),
+                  sizeof(chunk),
+                  chunk);
+        phase.appBytes += sizeof(chunk);
+    }
+    errClose = OS_FileSystemFile_close(hFs, hFile);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("OS_FileSystemFile_write() failed with %d", err);
+        return err;
+    }
+    if (OS_SUCCESS != errClose)
+    {
+        Debug_LOG_ERROR("OS_FileSystemFile_close() failed with %d", errClose);
+        return errClose;
+    }
+    phaseEnd(&phase, numChunks);
+
+    phaseStart(&phase, fsName, "stream read");
+    err = OS_FileSystemFile_open(
+              hFs,
+              &hFile,
+              name,
+              OS_FileSystem_OpenMode_RDONLY,
+              OS_FileSystem_OpenFlags_NONE);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("OS_FileSystemFile_open() failed with %d", err);
+        return err;
+    }
+    for (size_t i = 0; (i < numChunks) && (OS_SUCCESS == err); i++)
+    {
+        err = OS_FileSystemFile_read(
+                  hFs,
+                  hFile,
+                  i * sizeof(chunk),
+                  sizeof(chunk),
+                  chunk);
+    }
+    errClose = OS_FileSystemFile_close(hFs, hFile);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("OS_FileSystemFile_read() failed with %d", err);
+        return err;
+    }
+    if (OS_SUCCESS != errClose)
+    {
+        Debug_LOG_ERROR("OS_FileSystemFile_close() failed with %d", errClose);
+        return errClose;
+    }
+    phaseEnd(&phase, numChunks);
+
+    if ((err = OS_FileSystemFile_delete(hFs, name)) != OS_SUCCESS)
+    {
+        Debug_LOG_ERROR("OS_FileSystemFile_delete() failed with %d", err);
+    }
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+benchmarkFileSystem(
+    OS_FileSystem_Type_t type,
+    const char*          fsName)
+{
+    OS_FileSystem_Handle_t hFs;
+    OS_Error_t err;
+    Phase_t phase;
+
+    OS_FileSystem_Config_t cfg =
+    {
+        .type    = type,
+        .size    = OS_FileSystem_USE_STORAGE_MAX,
+        .storage = countingStorage,
+    };
+
+    if ((err = OS_FileSystem_init(&hFs, &cfg)) != OS_SUCCESS)
+    {
+        Debug_LOG_ERROR("OS_FileSystem_init() failed with %d", err);
+        return err;
+    }
+
+    phaseStart(&phase, fsName, "format+mount");
+    if ((err = OS_FileSystem_format(hFs)) != OS_SUCCESS)
+    {
+        Debug_LOG_ERROR("OS_FileSystem_format() failed with %d", err);
+        goto err0;
+    }
+    if ((err = OS_FileSystem_mount(hFs)) != OS_SUCCESS)
+    {
+        Debug_LOG_ERROR("OS_FileSystem_mount() failed with %d", err);
+        goto err0;
+    }
+    phaseEnd(&phase, 1);
+
+    if ((err = runMetadataWorkload(hFs, fsName)) != OS_SUCCESS)
+    {
+        goto err1;
+    }
+
+    err = runStreamingWorkload(hFs, fsName);
+
+err1:
+    OS_FileSystem_unmount(hFs);
+err0:
+    OS_FileSystem_free(hFs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+int
+run()
+{
+    DECL_UNUSED_VAR(OS_Error_t err) = SysLoggerClient_init(sysLogger_Rpc_log);
+    Debug_ASSERT(err == OS_SUCCESS);
+
+    static const struct
+    {
+        OS_FileSystem_Type_t type;
+        const char*          name;
+    } fileSystems[] =
+    {
+        { OS_FileSystem_Type_FATFS,    "FAT"      },
+        { OS_FileSystem_Type_LITTLEFS, "littlefs" },
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(fileSystems); i++)
+    {
+        if (benchmarkFileSystem(fileSystems[i].type, fileSystems[i].name)
+            != OS_SUCCESS)
+        {
+            Debug_LOG_ERROR(
+                "%s -> !!! Benchmark of %s failed.",
+                get_instance_name(),
+                fileSystems[i].name);
+            return -1;
+        }
+    }
+
+    Debug_LOG_INFO(
+        "%s -> !!! All benchmarks successfully completed.",
+        get_instance_name());
+
+    return 0;
+}
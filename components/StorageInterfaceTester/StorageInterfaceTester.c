@@ -9,6 +9,12 @@
  */
 
 #include "test_storage.h"
+#include "test_replay.h"
+#include "benchmark_storage.h"
+#include "benchmark_soak.h"
+#include "benchmark_cycles.h"
+#include "tester_log.h"
+#include "system_config.h"
 #include "lib_compiler/compiler.h"
 #include "lib_debug/Debug.h"
 #include "SysLoggerClient.h"
@@ -22,9 +28,27 @@ int run()
     DECL_UNUSED_VAR(OS_Error_t err) = SysLoggerClient_init(sysLogger_Rpc_log);
     Debug_ASSERT(err == OS_SUCCESS);
 
+    tester_log_init();
+
     uint32_t stateBitmap = 0;
 
-    if (!strcmp(get_instance_name(), "tester_sdhc") &&
+    if (boot_timing)
+    {
+        benchmark_storage_timeToFirstIo();
+    }
+
+    if (wait_for_turn)
+    {
+        turn_wait();
+    }
+
+    if (TESTER_REPLAY_OFF != replay_mode)
+    {
+        // This instance replays a recorded trace instead of running the
+        // generic tests.
+        test_replay_trace(TESTER_REPLAY_TIMED == replay_mode);
+    }
+    else if (!strcmp(get_instance_name(), "tester_sdhc") &&
         storage_rpc_getState(&stateBitmap) == OS_ERROR_DEVICE_NOT_PRESENT)
     {
         // This test systems is used to test also the special case of a system
@@ -46,7 +70,10 @@ int run()
         test_storage_writeReadEraseZeroBytes_pos();
         test_storage_neighborRegionsUntouched_pos();
 
-        // test_storage_writeReadEraseLargerThanBuf_neg();
+        if (test_port_limit)
+        {
+            test_storage_writeReadEraseLargerThanBuf_neg();
+        }
 
         test_storage_writeReadEraseOutside_neg();
         test_storage_writeReadEraseNegOffset_neg();
@@ -55,11 +82,46 @@ int run()
 
         test_storage_writeReadEraseSizeTooLarge_neg();
         test_storage_writeReadEraseSizeMax_neg();
+
+        if (bench_size_sweep)
+        {
+            benchmark_storage_sizeSweep();
+        }
+
+        if (bench_window_sweep)
+        {
+            benchmark_storage_windowSweep();
+        }
+
+        if (bench_rmw)
+        {
+            benchmark_storage_rmwPenalty();
+        }
+
+        if (bench_erase)
+        {
+            benchmark_storage_eraseSweep();
+        }
+
+        if (TESTER_CYCLES_OFF != bench_cycles)
+        {
+            benchmark_cycles_run(bench_cycles);
+        }
+
+        if (soak_duration_s > 0)
+        {
+            benchmark_soak_run(soak_duration_s, soak_window_s);
+        }
     }
 
     Debug_LOG_INFO(
         "%s -> !!! All tests successfully completed.",
         get_instance_name());
 
+    if (pass_turn)
+    {
+        turn_done_emit();
+    }
+
     return 0;
 }
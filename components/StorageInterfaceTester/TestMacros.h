@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "tester_log.h"
 #include "lib_debug/Debug.h"
 
 #include <string.h>
@@ -42,10 +43,11 @@ static char testName[MAX_MSG_LEN] = "<undefined>";
     snprintf(testName, sizeof(testName), "%s", __func__)
 #define TEST_START(...) \
     SELECT_START(_TEST_START, ## __VA_ARGS__,STOP,2,1,0)(__VA_ARGS__)
-// This outputs the tests name as a marker that it has been completed. Also, we
-// reset the testName to make incorrect use of TEST_START/TEST_FINISH more easy
-// to spot.
+// This outputs the tests name as a marker that it has been completed, after the
+// messages the test has buffered. Also, we reset the testName to make incorrect
+// use of TEST_START/TEST_FINISH more easy to spot.
 #define TEST_FINISH() { \
+    tester_log_flush(); \
     Debug_LOG_INFO("%s -> !!! %s: OK", get_instance_name(), testName); \
     snprintf(testName, sizeof(testName), "<undefined>"); \
 }
@@ -70,6 +72,7 @@ static char testName[MAX_MSG_LEN] = "<undefined>";
             printf("Message was truncated.\n"); \
         } \
 \
+        tester_log_flush(); \
         __assert_fail(msg, __FILE__, __LINE__, __func__); \
     } \
 } while(0)
@@ -185,5 +188,6 @@ static char testName[MAX_MSG_LEN] = "<undefined>";
     char msg[MAX_MSG_LEN];                                                   \
     int ret = snprintf(msg, sizeof(msg), "@%s: %s", testName, #st);          \
     if(ret>=sizeof(msg)) { /*Message was truncated */};                      \
-    ((void)((st) || (__assert_fail(msg, __FILE__, __LINE__, __func__),0)));  \
+    ((void)((st) || (tester_log_flush(),                                     \
+                     __assert_fail(msg, __FILE__, __LINE__, __func__),0)));  \
 }
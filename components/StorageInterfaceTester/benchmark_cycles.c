@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "benchmark_cycles.h"
+#include "tester_counters.h"
+#include "tester_stats.h"
+#include "system_config.h"
+#include "OS_Dataport.h"
+#include "TestMacros.h"
+
+#define CYCLES_PATTERN  0x3C
+
+typedef enum
+{
+    CYCLES_OP_GET_SIZE,
+    CYCLES_OP_WRITE,
+    CYCLES_OP_READ,
+    CYCLES_OP_ERASE,
+} CyclesOp_t;
+
+static const OS_Dataport_t storagePort = OS_DATAPORT_ASSIGN(storage_port);
+
+static const struct
+{
+    CyclesOp_t  op;
+    const char* name;
+} ops[] =
+{
+    { CYCLES_OP_GET_SIZE, "getSize" },
+    { CYCLES_OP_WRITE,    "write"   },
+    { CYCLES_OP_READ,     "read"    },
+    { CYCLES_OP_ERASE,    "erase"   },
+};
+
+static uint64_t instructions[BENCH_CYCLES_REPETITIONS];
+static uint64_t cycles[BENCH_CYCLES_REPETITIONS];
+
+static OS_Error_t
+doOp(
+    CyclesOp_t op,
+    size_t     size)
+{
+    size_t processed = 0;
+    off_t  erased    = 0;
+    off_t  storageSize;
+
+    switch (op)
+    {
+    case CYCLES_OP_GET_SIZE:
+        return storage_rpc_getSize(&storageSize);
+    case CYCLES_OP_WRITE:
+        return storage_rpc_write(0, size, &processed);
+    case CYCLES_OP_READ:
+        return storage_rpc_read(0, size, &processed);
+    default:
+        return storage_rpc_erase(0, size, &erased);
+    }
+}
+
+static void
+sort(
+    uint64_t* values,
+    size_t    num)
+{
+    for (size_t i = 1; i < num; i++)
+    {
+        const uint64_t v = values[i];
+        size_t j = i;
+
+        for (; (j > 0) && (values[j - 1] > v); j--)
+        {
+            values[j] = values[j - 1];
+        }
+        values[j] = v;
+    }
+}
+
+static TesterCounters_t
+measureOverhead(void)
+{
+    TesterCounters_t minCost = { UINT64_MAX, UINT64_MAX };
+
+    for (unsigned int i = 0; i < BENCH_CYCLES_REPETITIONS; i++)
+    {
+        TesterCounters_t start, end;
+
+        tester_counters_read(&start);
+        tester_counters_read(&end);
+
+        const TesterCounters_t cost = tester_counters_diff(&start, &end);
+
+        minCost.instructions = (cost.instructions < minCost.instructions)
+                               ? cost.instructions : minCost.instructions;
+        minCost.cycles       = (cost.cycles < minCost.cycles)
+                               ? cost.cycles : minCost.cycles;
+    }
+
+    return minCost;
+}
+
+static void
+measure(
+    CyclesOp_t              op,
+    const char*             name,
+    size_t                  size,
+    const TesterCounters_t* overhead)
+{
+    char statsName[64];
+
+    // The first request may take a different path, e.g. fault in pages.
+    TEST_SUCCESS(doOp(op, size));
+
+    // Fetching the statistics is not counted, only the requests are.
+    tester_stats_begin();
+
+    for (unsigned int i = 0; i < BENCH_CYCLES_REPETITIONS; i++)
+    {
+        TesterCounters_t start, end;
+
+        tester_counters_read(&start);
+        const OS_Error_t err = doOp(op, size);
+        tester_counters_read(&end);
+
+        TEST_SUCCESS(err);
+
+        const TesterCounters_t cost = tester_counters_diff(&start, &end);
+
+        instructions[i] = (cost.instructions > overhead->instructions)
+                          ? cost.instructions - overhead->instructions : 0;
+        cycles[i]       = (cost.cycles > overhead->cycles)
+                          ? cost.cycles - overhead->cycles : 0;
+    }
+
+    snprintf(statsName, sizeof(statsName), "cycles %s size=%zu", name, size);
+    tester_stats_end(
+        statsName,
+        (CYCLES_OP_WRITE == op) ? (uint64_t)size * BENCH_CYCLES_REPETITIONS : 0,
+        NULL);
+
+    sort(instructions, BENCH_CYCLES_REPETITIONS);
+    sort(cycles, BENCH_CYCLES_REPETITIONS);
+
+    if (!tester_counters_hasCycles())
+    {
+        TESTER_LOG_INFO(
+            "%s: cycles %-7s size=%-7zu instructions min/median/max="
+            "%" PRIu64 "/%" PRIu64 "/%" PRIu64 ", cycles n/a",
+            get_instance_name(),
+            name,
+            size,
+            instructions[0],
+            instructions[BENCH_CYCLES_REPETITIONS / 2],
+            instructions[BENCH_CYCLES_REPETITIONS - 1]);
+        return;
+    }
+
+    TESTER_LOG_INFO(
+        "%s: cycles %-7s size=%-7zu instructions min/median/max="
+        "%" PRIu64 "/%" PRIu64 "/%" PRIu64 ", "
+        "cycles min/median/max=%" PRIu64 "/%" PRIu64 "/%" PRIu64,
+        get_instance_name(),
+        name,
+        size,
+        instructions[0],
+        instructions[BENCH_CYCLES_REPETITIONS / 2],
+        instructions[BENCH_CYCLES_REPETITIONS - 1],
+        cycles[0],
+        cycles[BENCH_CYCLES_REPETITIONS / 2],
+        cycles[BENCH_CYCLES_REPETITIONS - 1]);
+}
+
+void
+benchmark_cycles_run(int source)
+{
+    TEST_START(source);
+
+    if (!tester_counters_init(source))
+    {
+        Debug_LOG_WARNING(
+            "%s: counter source %d is not available in this build, skipped",
+            get_instance_name(),
+            source);
+        TEST_FINISH();
+        return;
+    }
+
+    off_t  storageSize = 0;
+    size_t blockSize   = 0;
+    TEST_SUCCESS(storage_rpc_getSize(&storageSize));
+    TEST_SUCCESS(storage_rpc_getBlockSize(&blockSize));
+    ASSERT_LT_SZ((size_t)0U, blockSize);
+
+    const size_t portSize = (OS_Dataport_getSize(storagePort) / blockSize)
+                            * blockSize;
+    const size_t maxSize  = ((off_t)portSize < storageSize)
+                            ? portSize
+                            : (size_t)((storageSize / blockSize) * blockSize);
+    TEST_TRUE(maxSize > 0);
+
+    // One block, one page and a full dataport, all of them whole blocks.
+    const size_t pageSize = (4096 / blockSize) * blockSize;
+    const size_t sizes[]  = { blockSize, pageSize, maxSize };
+
+    memset(OS_Dataport_getBuf(storagePort), CYCLES_PATTERN, portSize);
+
+    const TesterCounters_t overhead = measureOverhead();
+
+    if (tester_counters_hasCycles())
+    {
+        TESTER_LOG_INFO(
+            "%s: cycles: reading the counters costs %" PRIu64 " instructions, "
+            "%" PRIu64 " cycles",
+            get_instance_name(),
+            overhead.instructions,
+            overhead.cycles);
+    }
+    else
+    {
+        TESTER_LOG_INFO(
+            "%s: cycles: reading the counters costs %" PRIu64 " instructions",
+            get_instance_name(),
+            overhead.instructions);
+    }
+
+    for (unsigned int o = 0; o < (sizeof(ops) / sizeof(ops[0])); o++)
+    {
+        if (CYCLES_OP_ERASE == ops[o].op)
+        {
+            off_t erased = 0;
+            if (OS_ERROR_NOT_IMPLEMENTED == storage_rpc_erase(0, 0, &erased))
+            {
+                TESTER_LOG_INFO(
+                    "%s: cycles: erase is not implemented, skipped",
+                    get_instance_name());
+                continue;
+            }
+        }
+
+        size_t lastSize = 0;
+
+        for (unsigned int s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); s++)
+        {
+            if ((sizes[s] <= lastSize) || (sizes[s] > maxSize))
+            {
+                continue;
+            }
+            lastSize = sizes[s];
+
+            measure(ops[o].op, ops[o].name, sizes[s], &overhead);
+
+            // getSize() does not depend on the size.
+            if (CYCLES_OP_GET_SIZE == ops[o].op)
+            {
+                break;
+            }
+        }
+    }
+
+    TEST_FINISH();
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Instruction and cycle count benchmark
+ *
+ * Counts the instructions and cycles every storage operation takes, from one
+ * of the deterministic counter sources in tester_counters.h instead of the
+ * wall clock. Running it on several stacks shows what every layer costs, and
+ * a change in the code of a stack shows up as a reproducible difference.
+ */
+#pragma once
+
+/**
+ * @brief   Counts the instructions and cycles of the storage operations.
+ *
+ * Every operation is repeated BENCH_CYCLES_REPETITIONS times at the same
+ * offset for sizes from one block up to the dataport size. The minimum,
+ * median and maximum are reported after subtracting the cost of reading the
+ * counters. Other components running in between are counted as well, which
+ * shows as a difference between minimum and maximum.
+ *
+ * @param   source  counter source, one of TESTER_CYCLES_xxx
+ */
+void benchmark_cycles_run(int source);
@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "benchmark_soak.h"
+#include "tester_timer.h"
+#include "tester_stats.h"
+#include "system_config.h"
+#include "OS_Dataport.h"
+#include "TestMacros.h"
+
+#define SOAK_PATTERN        0xC3
+
+// Latencies are counted in a log-linear histogram: values below 4 us have
+// their own bucket, every power of two above is split into 4 buckets. That
+// is at most 25% off, needs no allocation and covers the whole uint64_t range.
+#define HIST_SUB_BITS       2
+#define HIST_SUB_BUCKETS    (1U << HIST_SUB_BITS)
+#define HIST_NUM_BUCKETS    (64 * HIST_SUB_BUCKETS)
+
+typedef enum
+{
+    SOAK_OP_WRITE,
+    SOAK_OP_READ,
+    SOAK_OP_ERASE,
+    SOAK_OP_NUM
+} SoakOp_t;
+
+typedef struct
+{
+    uint64_t numOps[SOAK_OP_NUM];
+    uint64_t numBytes;
+    uint64_t maxUs;
+    uint32_t hist[HIST_NUM_BUCKETS];
+} SoakWindow_t;
+
+static const OS_Dataport_t storagePort = OS_DATAPORT_ASSIGN(storage_port);
+
+// Static, as it is too big for the stack of the control thread.
+static SoakWindow_t window;
+static uint32_t     rngState = 1;
+
+// xorshift32, the workload is the same in every run.
+static uint32_t
+nextRandom(void)
+{
+    uint32_t x = rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rngState = x;
+    return x;
+}
+
+static unsigned int
+bucketOf(
+    uint64_t us)
+{
+    if (us < HIST_SUB_BUCKETS)
+    {
+        return (unsigned int)us;
+    }
+
+    const unsigned int msb = 63 - __builtin_clzll(us);
+    const unsigned int sub = (us >> (msb - HIST_SUB_BITS)) & (HIST_SUB_BUCKETS - 1);
+
+    return ((msb - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS) + sub;
+}
+
+// Largest value counted in a bucket.
+static uint64_t
+bucketUpperUs(
+    unsigned int bucket)
+{
+    if (bucket < HIST_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    const unsigned int shift = (bucket / HIST_SUB_BUCKETS) - 1;
+    const uint64_t     lower = (uint64_t)(HIST_SUB_BUCKETS
+                                          + (bucket % HIST_SUB_BUCKETS))
+                               << shift;
+
+    return lower + (1ULL << shift) - 1;
+}
+
+static uint64_t
+percentileUs(
+    const SoakWindow_t* w,
+    uint64_t            numOps,
+    unsigned int        pct)
+{
+    const uint64_t rank = ((numOps * pct) + 99) / 100;
+    uint64_t count = 0;
+
+    for (unsigned int b = 0; b < HIST_NUM_BUCKETS; b++)
+    {
+        count += w->hist[b];
+        if ((count >= rank) && (count > 0))
+        {
+            const uint64_t upper = bucketUpperUs(b);
+            return (upper < w->maxUs) ? upper : w->maxUs;
+        }
+    }
+
+    return w->maxUs;
+}
+
+static bool
+isDrifted(
+    uint64_t base,
+    uint64_t value,
+    bool     isHigherWorse)
+{
+    if (0 == base)
+    {
+        return false;
+    }
+
+    const uint64_t limit = (base * SOAK_DRIFT_PCT) / 100;
+
+    return isHigherWorse ? (value > (base + limit))
+                         : ((value + limit) < base);
+}
+
+static void
+runOp(
+    off_t     storageSize,
+    size_t    blockSize,
+    size_t    maxBlocks,
+    bool*     isEraseSupported)
+{
+    const uint32_t pick = nextRandom() % 100;
+    SoakOp_t op = (pick < SOAK_WRITE_PCT) ? SOAK_OP_WRITE
+                  : (pick < (SOAK_WRITE_PCT + SOAK_ERASE_PCT)) ? SOAK_OP_ERASE
+                  : SOAK_OP_READ;
+    if ((SOAK_OP_ERASE == op) && !*isEraseSupported)
+    {
+        op = SOAK_OP_READ;
+    }
+
+    const size_t size   = (1 + (nextRandom() % maxBlocks)) * blockSize;
+    const off_t  offset = (nextRandom() % ((storageSize - size) / blockSize + 1))
+                          * blockSize;
+
+    size_t processed = 0;
+    off_t  erased    = 0;
+    OS_Error_t err;
+
+    const uint64_t startUs = tester_timer_getTimeUs();
+
+    switch (op)
+    {
+    case SOAK_OP_WRITE:
+        err = storage_rpc_write(offset, size, &processed);
+        break;
+    case SOAK_OP_ERASE:
+        err = storage_rpc_erase(offset, size, &erased);
+        processed = erased;
+        break;
+    default:
+        err = storage_rpc_read(offset, size, &processed);
+        break;
+    }
+
+    const uint64_t us = tester_timer_getTimeUs() - startUs;
+
+    if ((SOAK_OP_ERASE == op) && (OS_ERROR_NOT_IMPLEMENTED == err))
+    {
+        Debug_LOG_INFO(
+            "%s: soak: erase is not implemented, using reads instead",
+            get_instance_name());
+        *isEraseSupported = false;
+        return;
+    }
+    TEST_SUCCESS(err);
+    ASSERT_EQ_SZ(size, processed);
+
+    TESTER_LOG_DEBUG(
+        "%s: soak op=%d offset=%" PRIiMAX " size=%zu took %" PRIu64 " us",
+        get_instance_name(), op, (intmax_t)offset, size, us);
+
+    window.numOps[op]++;
+    window.numBytes += size;
+    window.hist[bucketOf(us)]++;
+    window.maxUs = (us > window.maxUs) ? us : window.maxUs;
+}
+
+void
+benchmark_soak_run(
+    uint64_t durationS,
+    uint64_t windowS)
+{
+    TEST_START(durationS, windowS);
+
+    off_t  storageSize = 0;
+    size_t blockSize   = 0;
+    TEST_SUCCESS(storage_rpc_getSize(&storageSize));
+    TEST_SUCCESS(storage_rpc_getBlockSize(&blockSize));
+    ASSERT_LT_SZ((size_t)0U, blockSize);
+
+    // Requests are between one block and the dataport size, but never larger
+    // than the storage.
+    const size_t portBlocks    = OS_Dataport_getSize(storagePort) / blockSize;
+    const size_t storageBlocks = storageSize / blockSize;
+    const size_t maxBlocks     = (portBlocks < storageBlocks)
+                                 ? portBlocks : storageBlocks;
+    TEST_TRUE(maxBlocks > 0);
+    TEST_TRUE(windowS > 0);
+
+    memset(
+        OS_Dataport_getBuf(storagePort),
+        SOAK_PATTERN,
+        OS_Dataport_getSize(storagePort));
+
+    const uint64_t windowUs = windowS * 1000000;
+    const uint64_t endUs    = tester_timer_getTimeUs() + (durationS * 1000000);
+
+    bool     isEraseSupported = true;
+    uint64_t baseKiBPerSec    = 0;
+    uint64_t baseP99Us        = 0;
+    uint64_t minKiBPerSec     = UINT64_MAX;
+    uint64_t maxKiBPerSec     = 0;
+    unsigned int numWindows   = 0;
+    unsigned int numDrifted   = 0;
+
+    for (uint64_t nowUs = tester_timer_getTimeUs(); nowUs < endUs;)
+    {
+        memset(&window, 0, sizeof(window));
+        tester_stats_begin();
+
+        const uint64_t startUs = nowUs;
+        while ((nowUs - startUs) < windowUs)
+        {
+            runOp(storageSize, blockSize, maxBlocks, &isEraseSupported);
+            nowUs = tester_timer_getTimeUs();
+        }
+
+        const uint64_t elapsedUs = nowUs - startUs;
+        const uint64_t numOps    = window.numOps[SOAK_OP_WRITE]
+                                   + window.numOps[SOAK_OP_READ]
+                                   + window.numOps[SOAK_OP_ERASE];
+        const uint64_t kibPerSec = ((window.numBytes * 1000000) / 1024)
+                                   / elapsedUs;
+        const uint64_t p99Us     = percentileUs(&window, numOps, 99);
+
+        // The first window is the reference the others are compared to.
+        if (0 == numWindows)
+        {
+            baseKiBPerSec = kibPerSec;
+            baseP99Us     = p99Us;
+        }
+
+        const bool isThroughputDrifted = isDrifted(
+                                             baseKiBPerSec, kibPerSec, false);
+        const bool isLatencyDrifted    = isDrifted(baseP99Us, p99Us, true);
+
+        numWindows++;
+        numDrifted += (isThroughputDrifted || isLatencyDrifted) ? 1 : 0;
+        minKiBPerSec = (kibPerSec < minKiBPerSec) ? kibPerSec : minKiBPerSec;
+        maxKiBPerSec = (kibPerSec > maxKiBPerSec) ? kibPerSec : maxKiBPerSec;
+
+        // The per request messages of the window come first. The results are
+        // logged directly, so they are never dropped if the requests filled
+        // the log buffer.
+        tester_log_flush();
+
+        Debug_LOG_INFO(
+            "%s: soak window %u: ops w/r/e=%" PRIu64 "/%" PRIu64 "/%" PRIu64
+            ", %" PRIu64 " KiB/s, latency us p50/p90/p99/max="
+            "%" PRIu64 "/%" PRIu64 "/%" PRIu64 "/%" PRIu64,
+            get_instance_name(),
+            numWindows,
+            window.numOps[SOAK_OP_WRITE],
+            window.numOps[SOAK_OP_READ],
+            window.numOps[SOAK_OP_ERASE],
+            kibPerSec,
+            percentileUs(&window, numOps, 50),
+            percentileUs(&window, numOps, 90),
+            p99Us,
+            window.maxUs);
+
+        if (isThroughputDrifted || isLatencyDrifted)
+        {
+            Debug_LOG_WARNING(
+                "%s: soak window %u drifted more than %d%% from the first "
+                "window: %" PRIu64 " KiB/s (was %" PRIu64 "), p99 %" PRIu64
+                " us (was %" PRIu64 ")",
+                get_instance_name(),
+                numWindows,
+                SOAK_DRIFT_PCT,
+                kibPerSec,
+                baseKiBPerSec,
+                p99Us,
+                baseP99Us);
+        }
+
+        tester_stats_end("soak window", 0, NULL);
+
+        // The next window starts after the messages of this one are out.
+        tester_log_flush();
+        nowUs = tester_timer_getTimeUs();
+    }
+
+    Debug_LOG_INFO(
+        "%s: soak finished after %u windows, %u drifted, "
+        "throughput min/max=%" PRIu64 "/%" PRIu64 " KiB/s",
+        get_instance_name(),
+        numWindows,
+        numDrifted,
+        minKiBPerSec,
+        maxKiBPerSec);
+
+    TEST_FINISH();
+}
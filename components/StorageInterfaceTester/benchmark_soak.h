@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Long running soak benchmark
+ *
+ * Runs a random mix of writes, reads and erases against the storage under test
+ * and reports throughput and latency percentiles for every time window. Windows
+ * whose throughput or 99th percentile latency drifted more than
+ * SOAK_DRIFT_PCT from the first window are flagged. Requires the tester
+ * instance to be connected to a TimeServer.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief   Runs the soak benchmark.
+ *
+ * @param   durationS   total run time in seconds
+ * @param   windowS     length of a reporting window in seconds
+ */
+void benchmark_soak_run(uint64_t durationS, uint64_t windowS);
@@ -0,0 +1,533 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "benchmark_storage.h"
+#include "tester_timer.h"
+#include "tester_stats.h"
+#include "system_config.h"
+#include "OS_Dataport.h"
+#include "TestMacros.h"
+#include "BootTiming.h"
+#include "StorageClient.h"
+
+#include <stdlib.h>
+
+#define BENCH_ALIGNMENT     4096
+#define BENCH_MAX_POINTS    32
+#define BENCH_PATTERN       0x5A
+#define BENCH_ERASED        0xFF
+
+typedef struct
+{
+    size_t   size;
+    uint64_t totalUs;
+    uint64_t kibPerSec;
+} SweepPoint_t;
+
+typedef struct
+{
+    const char* name;
+    bool        isHeadPartial;
+    bool        isTailPartial;
+} RmwPattern_t;
+
+static const OS_Dataport_t storagePort = OS_DATAPORT_ASSIGN(storage_port);
+
+static const if_OS_Storage_t storage =
+    IF_OS_STORAGE_ASSIGN(
+        storage_rpc,
+        storage_port);
+
+static const RmwPattern_t rmwPatterns[] =
+{
+    { "aligned", false, false },
+    { "head",    true,  false },
+    { "tail",    false, true  },
+    { "both",    true,  true  },
+};
+
+static void
+getGeometry(
+    off_t*  storageSize,
+    size_t* blockSize)
+{
+    TEST_SUCCESS(storage_rpc_getSize(storageSize));
+    TEST_SUCCESS(storage_rpc_getBlockSize(blockSize));
+    ASSERT_LT_SZ((size_t)0U, *blockSize);
+}
+
+static uint64_t
+kibPerSec(
+    uint64_t bytes,
+    uint64_t us)
+{
+    return (us > 0) ? ((bytes * 1000000) / 1024) / us : 0;
+}
+
+static bool
+isErasedPattern(
+    const uint8_t* buf,
+    size_t         size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (BENCH_ERASED != buf[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static uint64_t
+usPerMiB(
+    uint64_t us,
+    uint64_t bytes)
+{
+    return (bytes > 0) ? (us * 1024 * 1024) / bytes : 0;
+}
+
+static void
+measureSweepPoint(
+    bool         isWrite,
+    off_t        shift,
+    off_t        storageSize,
+    SweepPoint_t* point)
+{
+    char name[64];
+    StorageStats_t stats;
+    memset(&stats, 0, sizeof(stats));
+
+    // Every request goes to a different, aligned location so that caching
+    // on the medium does not distort the results.
+    const off_t stride = ((point->size + shift + BENCH_ALIGNMENT - 1)
+                          / BENCH_ALIGNMENT) * BENCH_ALIGNMENT;
+    const off_t numSlots = storageSize / stride;
+    TEST_TRUE(numSlots > 0);
+
+    snprintf(
+        name, sizeof(name), "%s size=%zu shift=%" PRIiMAX,
+        isWrite ? "write" : "read", point->size, (intmax_t)shift);
+
+    tester_stats_begin();
+    const uint64_t startUs = tester_timer_getTimeUs();
+
+    for (unsigned int i = 0; i < BENCH_SWEEP_REPETITIONS; i++)
+    {
+        const off_t offset = ((i % numSlots) * stride) + shift;
+        size_t processed = 0;
+
+        if (isWrite)
+        {
+            TEST_SUCCESS(storage_rpc_write(offset, point->size, &processed));
+        }
+        else
+        {
+            TEST_SUCCESS(storage_rpc_read(offset, point->size, &processed));
+        }
+        ASSERT_EQ_SZ(point->size, processed);
+    }
+
+    point->totalUs   = tester_timer_getTimeUs() - startUs;
+    point->kibPerSec = kibPerSec(
+                           (uint64_t)point->size * BENCH_SWEEP_REPETITIONS,
+                           point->totalUs);
+
+    tester_stats_end(
+        name,
+        isWrite ? (uint64_t)point->size * BENCH_SWEEP_REPETITIONS : 0,
+        &stats);
+
+    TESTER_LOG_INFO(
+        "%s: sweep %s: %" PRIu64 " us/request, %" PRIu64 " KiB/s, "
+        "backend requests per request %" PRIu64 ".%02" PRIu64 ", "
+        "backend %" PRIu64 " us/request",
+        get_instance_name(),
+        name,
+        point->totalUs / BENCH_SWEEP_REPETITIONS,
+        point->kibPerSec,
+        (stats.numWrites + stats.numReads) / BENCH_SWEEP_REPETITIONS,
+        (((stats.numWrites + stats.numReads) * 100) / BENCH_SWEEP_REPETITIONS)
+            % 100,
+        stats.busyUs / BENCH_SWEEP_REPETITIONS);
+}
+
+void
+benchmark_storage_timeToFirstIo()
+{
+    TEST_START();
+
+    off_t storageSize = 0;
+
+    BootTiming_LOG("run", tester_timer_getTimeUs());
+
+    // This blocks until the whole storage stack below us is up.
+    const uint64_t startUs = tester_timer_getTimeUs();
+    const OS_Error_t err = storage_rpc_getSize(&storageSize);
+    const uint64_t endUs = tester_timer_getTimeUs();
+
+    BootTiming_LOG(
+        (OS_SUCCESS == err) ? "first storage RPC" : "first storage RPC failed",
+        endUs);
+
+    Debug_LOG_INFO(
+        "%s: first storage_rpc_getSize() took %" PRIu64 " us, rslt = %i",
+        get_instance_name(),
+        endUs - startUs,
+        err);
+
+    TEST_FINISH();
+}
+
+void
+benchmark_storage_sizeSweep()
+{
+    TEST_START();
+
+    off_t  storageSize = 0;
+    size_t blockSize   = 0;
+    getGeometry(&storageSize, &blockSize);
+
+    const size_t portSize = OS_Dataport_getSize(storagePort);
+    memset(OS_Dataport_getBuf(storagePort), BENCH_PATTERN, portSize);
+
+    const off_t shifts[] = { 0, (off_t)blockSize };
+
+    for (unsigned int op = 0; op < 2; op++)
+    {
+        const bool isWrite = (0 == op);
+
+        for (unsigned int s = 0; s < (sizeof(shifts) / sizeof(shifts[0])); s++)
+        {
+            SweepPoint_t points[BENCH_MAX_POINTS];
+            size_t numPoints = 0;
+            uint64_t peakKiBPerSec = 0;
+
+            // Every size must leave room for its shift and alignment.
+            for (size_t size = blockSize;
+                 (size <= portSize)
+                 && ((off_t)(size + blockSize + BENCH_ALIGNMENT) <= storageSize)
+                 && (numPoints < BENCH_MAX_POINTS);
+                 size *= 2)
+            {
+                SweepPoint_t* point = &points[numPoints++];
+                point->size = size;
+
+                measureSweepPoint(isWrite, shifts[s], storageSize, point);
+
+                if (point->kibPerSec > peakKiBPerSec)
+                {
+                    peakKiBPerSec = point->kibPerSec;
+                }
+            }
+
+            // The crossover is the smallest request size which gets close
+            // enough to the best throughput.
+            for (size_t i = 0; i < numPoints; i++)
+            {
+                if ((points[i].kibPerSec * 100)
+                    >= (peakKiBPerSec * BENCH_SWEEP_CROSSOVER_PCT))
+                {
+                    TESTER_LOG_INFO(
+                        "%s: sweep %s shift=%" PRIiMAX ": crossover at "
+                        "%zu bytes (%" PRIu64 " KiB/s, peak %" PRIu64 " KiB/s)",
+                        get_instance_name(),
+                        isWrite ? "write" : "read",
+                        (intmax_t)shifts[s],
+                        points[i].size,
+                        points[i].kibPerSec,
+                        peakKiBPerSec);
+                    break;
+                }
+            }
+        }
+    }
+
+    TEST_FINISH();
+}
+
+void
+benchmark_storage_windowSweep()
+{
+    TEST_START();
+
+    off_t  storageSize = 0;
+    size_t blockSize   = 0;
+    getGeometry(&storageSize, &blockSize);
+
+    const size_t portSize = OS_Dataport_getSize(storagePort);
+    memset(OS_Dataport_getBuf(storagePort), BENCH_PATTERN, portSize);
+
+    const size_t minWindow = (blockSize > BENCH_ALIGNMENT)
+                             ? blockSize : BENCH_ALIGNMENT;
+    char name[64];
+
+    for (unsigned int op = 0; op < 2; op++)
+    {
+        const bool isWrite = (0 == op);
+        uint64_t baseKiBPerSec = 0;
+
+        for (size_t window = minWindow;
+             (window <= portSize) && (window <= BENCH_WINDOW_TOTAL_SIZE);
+             window *= 2)
+        {
+            // The data is moved through the storage in consecutive windows,
+            // wrapping around at its end.
+            const off_t numSlots = storageSize / window;
+            TEST_TRUE(numSlots > 0);
+
+            const size_t numRpcs = BENCH_WINDOW_TOTAL_SIZE / window;
+
+            tester_stats_begin();
+            const uint64_t startUs = tester_timer_getTimeUs();
+
+            for (size_t i = 0; i < numRpcs; i++)
+            {
+                const off_t offset = (i % numSlots) * window;
+                size_t processed = 0;
+
+                if (isWrite)
+                {
+                    TEST_SUCCESS(storage_rpc_write(offset, window, &processed));
+                }
+                else
+                {
+                    TEST_SUCCESS(storage_rpc_read(offset, window, &processed));
+                }
+                ASSERT_EQ_SZ(window, processed);
+            }
+
+            const uint64_t totalUs = tester_timer_getTimeUs() - startUs;
+            const uint64_t throughput = kibPerSec(
+                                            (uint64_t)numRpcs * window,
+                                            totalUs);
+
+            snprintf(
+                name, sizeof(name), "window %s size=%zu",
+                isWrite ? "write" : "read", window);
+            tester_stats_end(
+                name,
+                isWrite ? (uint64_t)numRpcs * window : 0,
+                NULL);
+            if (0 == baseKiBPerSec)
+            {
+                baseKiBPerSec = throughput;
+            }
+
+            TESTER_LOG_INFO(
+                "%s: window %s size=%zu: %zu RPCs, %" PRIu64 " us/RPC, "
+                "%" PRIu64 " KiB/s, %" PRIu64 ".%02" PRIu64 "x of %zu bytes",
+                get_instance_name(),
+                isWrite ? "write" : "read",
+                window,
+                numRpcs,
+                totalUs / numRpcs,
+                throughput,
+                (baseKiBPerSec > 0) ? throughput / baseKiBPerSec : 0,
+                (baseKiBPerSec > 0)
+                    ? ((throughput * 100) / baseKiBPerSec) % 100 : 0,
+                minWindow);
+        }
+    }
+
+    TEST_FINISH();
+}
+
+void
+benchmark_storage_rmwPenalty()
+{
+    TEST_START();
+
+    StorageClient_t client;
+    TEST_SUCCESS(StorageClient_init(&client, &storage));
+
+    const size_t bs = client.blockSize;
+
+    if (bs < 4)
+    {
+        Debug_LOG_INFO(
+            "%s: rmw: block size is %zu, there are no partial blocks",
+            get_instance_name(), bs);
+        TEST_FINISH();
+        return;
+    }
+
+    // One block, several blocks in one RPC and several chunks, as far as
+    // they fit into half of the storage.
+    const size_t halfSize = StorageClient_roundDown(&client, client.size / 2);
+    const size_t maxSize  = ((4 * client.chunkSize) < halfSize)
+                            ? (4 * client.chunkSize) : halfSize;
+    const size_t sizes[]  = { bs, 8 * bs, maxSize };
+    TEST_TRUE(maxSize >= (8 * bs));
+    char name[64];
+
+    uint8_t* data = malloc(maxSize);
+    TEST_TRUE(NULL != data);
+    memset(data, BENCH_PATTERN, maxSize);
+
+    for (unsigned int s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); s++)
+    {
+        const off_t stride = ((sizes[s] + BENCH_ALIGNMENT - 1)
+                              / BENCH_ALIGNMENT) * BENCH_ALIGNMENT;
+        const off_t numSlots = client.size / stride;
+        TEST_TRUE(numSlots > 0);
+
+        uint64_t alignedUs = 0;
+
+        for (unsigned int p = 0;
+             p < (sizeof(rmwPatterns) / sizeof(rmwPatterns[0]));
+             p++)
+        {
+            const RmwPattern_t* pattern = &rmwPatterns[p];
+
+            // All patterns touch the same blocks, only the partially covered
+            // ones differ.
+            const off_t  headCut = pattern->isHeadPartial ? (bs / 2) : 0;
+            const size_t tailCut = pattern->isTailPartial ? (bs / 4) : 0;
+            const size_t size    = sizes[s] - headCut - tailCut;
+
+            const StorageClient_Counters_t start = client.counters;
+
+            tester_stats_begin();
+            const uint64_t startUs = tester_timer_getTimeUs();
+
+            for (unsigned int i = 0; i < BENCH_SWEEP_REPETITIONS; i++)
+            {
+                const off_t offset = ((i % numSlots) * stride) + headCut;
+                size_t written = 0;
+
+                TEST_SUCCESS(
+                    StorageClient_write(&client, offset, data, size, &written));
+                ASSERT_EQ_SZ(size, written);
+            }
+
+            const uint64_t us = (tester_timer_getTimeUs() - startUs)
+                                / BENCH_SWEEP_REPETITIONS;
+            const uint64_t writeRpcs = client.counters.numWriteRpcs
+                                       - start.numWriteRpcs;
+            const uint64_t rmwReads  = client.counters.numRmwReadRpcs
+                                       - start.numRmwReadRpcs;
+
+            snprintf(
+                name, sizeof(name), "rmw size=%zu %s",
+                sizes[s], pattern->name);
+            tester_stats_end(
+                name,
+                (uint64_t)size * BENCH_SWEEP_REPETITIONS,
+                NULL);
+
+            if (0 == p)
+            {
+                alignedUs = us;
+            }
+
+            TESTER_LOG_INFO(
+                "%s: rmw size=%zu %s: %" PRIu64 " us/request "
+                "(%+" PRIi64 "%% of aligned), write RPCs per request "
+                "%" PRIu64 ".%02" PRIu64 ", RMW reads per request "
+                "%" PRIu64 ".%02" PRIu64,
+                get_instance_name(),
+                sizes[s],
+                pattern->name,
+                us,
+                (alignedUs > 0)
+                    ? (((int64_t)us - (int64_t)alignedUs) * 100)
+                      / (int64_t)alignedUs
+                    : 0,
+                writeRpcs / BENCH_SWEEP_REPETITIONS,
+                ((writeRpcs * 100) / BENCH_SWEEP_REPETITIONS) % 100,
+                rmwReads / BENCH_SWEEP_REPETITIONS,
+                ((rmwReads * 100) / BENCH_SWEEP_REPETITIONS) % 100);
+        }
+    }
+
+    free(data);
+
+    TEST_FINISH();
+}
+
+void
+benchmark_storage_eraseSweep()
+{
+    TEST_START();
+
+    off_t  storageSize = 0;
+    size_t blockSize   = 0;
+    getGeometry(&storageSize, &blockSize);
+
+    const size_t portSize = (OS_Dataport_getSize(storagePort) / blockSize)
+                            * blockSize;
+    uint8_t* const buf    = OS_Dataport_getBuf(storagePort);
+    const off_t maxSize   = (storageSize / blockSize) * blockSize;
+
+    off_t size = (maxSize < BENCH_ALIGNMENT) ? maxSize : BENCH_ALIGNMENT;
+    char name[64];
+
+    while (size > 0)
+    {
+        size_t processed = 0;
+        off_t  erased    = 0;
+
+        // Make sure the range does not start out erased.
+        memset(buf, BENCH_PATTERN, portSize);
+        TEST_SUCCESS(
+            storage_rpc_write(
+                0,
+                ((off_t)portSize < size) ? portSize : (size_t)size,
+                &processed));
+
+        tester_stats_begin();
+        const uint64_t startUs = tester_timer_getTimeUs();
+        const OS_Error_t err   = storage_rpc_erase(0, size, &erased);
+        const uint64_t eraseUs = tester_timer_getTimeUs() - startUs;
+
+        if (OS_ERROR_NOT_IMPLEMENTED == err)
+        {
+            TESTER_LOG_INFO(
+                "%s: erase is not implemented, nothing to measure",
+                get_instance_name());
+            break;
+        }
+        TEST_SUCCESS(err);
+        ASSERT_EQ_INT_MAX((intmax_t)size, (intmax_t)erased);
+
+        const uint64_t verifyStartUs = tester_timer_getTimeUs();
+
+        for (off_t offset = 0; offset < size; offset += portSize)
+        {
+            const size_t len = ((size - offset) < (off_t)portSize)
+                               ? (size_t)(size - offset) : portSize;
+
+            TEST_SUCCESS(storage_rpc_read(offset, len, &processed));
+            ASSERT_EQ_SZ(len, processed);
+            TEST_TRUE(isErasedPattern(buf, len));
+        }
+
+        const uint64_t verifyUs = tester_timer_getTimeUs() - verifyStartUs;
+
+        snprintf(name, sizeof(name), "erase size=%" PRIiMAX, (intmax_t)size);
+        tester_stats_end(name, 0, NULL);
+
+        TESTER_LOG_INFO(
+            "%s: erase size=%" PRIiMAX ": erase %" PRIu64 " us "
+            "(%" PRIu64 " us/MiB), verify %" PRIu64 " us (%" PRIu64 " us/MiB)",
+            get_instance_name(),
+            (intmax_t)size,
+            eraseUs,
+            usPerMiB(eraseUs, size),
+            verifyUs,
+            usPerMiB(verifyUs, size));
+
+        // Double the size, but measure the whole storage as the last point.
+        size = (size == maxSize) ? 0
+               : ((2 * size) > maxSize) ? maxSize : (2 * size);
+    }
+
+    TEST_FINISH();
+}
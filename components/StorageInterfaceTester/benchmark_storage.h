@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Storage interface benchmarks
+ *
+ * Unlike the tests, the benchmarks do not verify the data but measure how the
+ * storage performs. They require the tester instance to be connected to a
+ * TimeServer and use the backend statistics if available (see
+ * tester_stats.h). Every benchmark overwrites the storage content.
+ */
+#pragma once
+
+/**
+ * @brief   Measures the time until the storage answers the first request.
+ *
+ * Must be called before any other storage RPC of the tester. Logs when run()
+ * was entered and when the first storage_rpc_getSize() returned, relative to
+ * the start of the TimeServer, in the format of include/BootTiming.h.
+ */
+void benchmark_storage_timeToFirstIo();
+
+/**
+ * @brief   Sweeps request sizes and alignments of writes and reads.
+ *
+ * Request sizes range from one block up to the dataport size, the requests are
+ * either aligned to 4 KiB or shifted by one block. Reports the time per
+ * request, the throughput, the number of backend requests each request caused
+ * and the smallest request size which reaches the full throughput.
+ */
+void benchmark_storage_sizeSweep();
+
+/**
+ * @brief   Moves BENCH_WINDOW_TOTAL_SIZE bytes for every window size from 4 KiB
+ *          up to the dataport size, i.e. with fewer but larger RPCs, and logs
+ *          the number of RPCs, the time per RPC and the throughput relative to
+ *          the smallest window.
+ */
+void benchmark_storage_windowSweep();
+
+/**
+ * @brief   Compares block aligned writes through the StorageClient library
+ *          with writes having a partial head block, a partial tail block or
+ *          both, and logs the read-modify-write penalty in time and RPCs.
+ */
+void benchmark_storage_rmwPenalty();
+
+/**
+ * @brief   Erases ranges from 4 KiB doubling up to the whole storage and logs
+ *          the time of the erase and of reading the range back to verify it,
+ *          in total and per MiB.
+ */
+void benchmark_storage_eraseSweep();
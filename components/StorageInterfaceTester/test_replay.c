@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "test_replay.h"
+#include "tester_timer.h"
+#include "tester_stats.h"
+#include "StorageTrace.h"
+#include "OS_Dataport.h"
+#include "TestMacros.h"
+
+#define REPLAY_WRITE_PATTERN 0xA5
+
+typedef struct
+{
+    size_t   numOps;
+    size_t   numMismatches;
+    uint64_t numBytes;
+    uint64_t totalUs;
+    uint64_t minUs;
+    uint64_t maxUs;
+    uint64_t recordedTotalUs;
+} ReplayStats_t;
+
+static const OS_Dataport_t tracePort   = OS_DATAPORT_ASSIGN(trace_port);
+static const OS_Dataport_t storagePort = OS_DATAPORT_ASSIGN(storage_port);
+
+static OS_Error_t
+replayRecord(
+    const StorageTrace_Record_t* rec,
+    int64_t*                     result)
+{
+    OS_Error_t err = OS_ERROR_NOT_SUPPORTED;
+
+    switch (rec->op)
+    {
+    case StorageTrace_OP_WRITE:
+    {
+        size_t written = 0;
+        err = storage_rpc_write(rec->offset, rec->size, &written);
+        *result = written;
+        break;
+    }
+    case StorageTrace_OP_READ:
+    {
+        size_t read = 0;
+        err = storage_rpc_read(rec->offset, rec->size, &read);
+        *result = read;
+        break;
+    }
+    case StorageTrace_OP_ERASE:
+    {
+        off_t erased = 0;
+        err = storage_rpc_erase(rec->offset, rec->size, &erased);
+        *result = erased;
+        break;
+    }
+    case StorageTrace_OP_GET_SIZE:
+    {
+        off_t size = 0;
+        err = storage_rpc_getSize(&size);
+        *result = size;
+        break;
+    }
+    case StorageTrace_OP_GET_BLOCK_SIZE:
+    {
+        size_t blockSize = 0;
+        err = storage_rpc_getBlockSize(&blockSize);
+        *result = blockSize;
+        break;
+    }
+    case StorageTrace_OP_GET_STATE:
+    {
+        uint32_t flags = 0;
+        err = storage_rpc_getState(&flags);
+        *result = flags;
+        break;
+    }
+    default:
+        *result = 0;
+        break;
+    }
+
+    return err;
+}
+
+static void
+logStats(
+    const ReplayStats_t stats[StorageTrace_OP_NUM],
+    uint64_t            elapsedUs)
+{
+    uint64_t totalBytes = 0;
+
+    for (unsigned int op = 0; op < StorageTrace_OP_NUM; op++)
+    {
+        const ReplayStats_t* s = &stats[op];
+        if (0 == s->numOps)
+        {
+            continue;
+        }
+
+        totalBytes += s->numBytes;
+
+        Debug_LOG_INFO(
+            "%s: replay %-12s ops=%zu bytes=%" PRIu64 " "
+            "latency us min/avg/max=%" PRIu64 "/%" PRIu64 "/%" PRIu64 " "
+            "(recorded avg=%" PRIu64 ") result mismatches=%zu",
+            get_instance_name(),
+            StorageTrace_opName(op),
+            s->numOps,
+            s->numBytes,
+            s->minUs,
+            s->totalUs / s->numOps,
+            s->maxUs,
+            s->recordedTotalUs / s->numOps,
+            s->numMismatches);
+    }
+
+    Debug_LOG_INFO(
+        "%s: replay took %" PRIu64 " us, throughput %" PRIu64 " KiB/s",
+        get_instance_name(),
+        elapsedUs,
+        (elapsedUs > 0) ? ((totalBytes * 1000000) / 1024) / elapsedUs : 0);
+}
+
+void
+test_replay_trace(bool honorTiming)
+{
+    TEST_START(honorTiming);
+
+    ReplayStats_t stats[StorageTrace_OP_NUM];
+    memset(stats, 0, sizeof(stats));
+
+    Debug_LOG_INFO("%s: waiting for the trace", get_instance_name());
+    trace_ready_wait();
+    __sync_synchronize();
+
+    const StorageTrace_Header_t* hdr = OS_Dataport_getBuf(tracePort);
+
+    ASSERT_EQ_UINT((unsigned int)StorageTrace_MAGIC, (unsigned int)hdr->magic);
+    ASSERT_EQ_UINT(
+        (unsigned int)StorageTrace_VERSION,
+        (unsigned int)hdr->version);
+    ASSERT_EQ_SZ(sizeof(StorageTrace_Record_t), (size_t)hdr->recordSize);
+    TEST_TRUE(hdr->flags & StorageTrace_FLAG_COMPLETE);
+    ASSERT_LE_SZ(
+        (size_t)hdr->numRecords,
+        StorageTrace_MAX_RECORDS(OS_Dataport_getSize(tracePort)));
+
+    const StorageTrace_Record_t* recs =
+        StorageTrace_getRecords(OS_Dataport_getBuf(tracePort));
+
+    // The content of the data written does not matter for the replay.
+    memset(
+        OS_Dataport_getBuf(storagePort),
+        REPLAY_WRITE_PATTERN,
+        OS_Dataport_getSize(storagePort));
+
+    uint64_t appBytesWritten = 0;
+
+    tester_stats_begin();
+    const uint64_t startUs = tester_timer_getTimeUs();
+
+    for (size_t i = 0; i < hdr->numRecords; i++)
+    {
+        const StorageTrace_Record_t* rec = &recs[i];
+
+        TEST_TRUE(rec->op < StorageTrace_OP_NUM);
+
+        if (honorTiming)
+        {
+            const uint64_t dueUs = startUs + rec->timestampUs;
+            const uint64_t nowUs = tester_timer_getTimeUs();
+            if (nowUs < dueUs)
+            {
+                tester_timer_sleepUs(dueUs - nowUs);
+            }
+        }
+
+        int64_t result = 0;
+
+        const uint64_t opStartUs = tester_timer_getTimeUs();
+        const OS_Error_t err = replayRecord(rec, &result);
+        const uint64_t opUs = tester_timer_getTimeUs() - opStartUs;
+
+        ReplayStats_t* s = &stats[rec->op];
+
+        s->minUs = ((0 == s->numOps) || (opUs < s->minUs)) ? opUs : s->minUs;
+        s->maxUs = (opUs > s->maxUs) ? opUs : s->maxUs;
+        s->numOps++;
+        s->totalUs += opUs;
+        s->recordedTotalUs += rec->durationUs;
+
+        // Only the data moving operations count for the throughput.
+        if ((OS_SUCCESS == err) && (rec->op <= StorageTrace_OP_ERASE))
+        {
+            s->numBytes += result;
+        }
+
+        if ((OS_SUCCESS == err) && (StorageTrace_OP_WRITE == rec->op))
+        {
+            appBytesWritten += result;
+        }
+
+        // Another backend may legitimately behave differently, so we only
+        // report deviations from the recording.
+        if ((err != rec->err) || (result != rec->result))
+        {
+            TESTER_LOG_DEBUG(
+                "%s: record %zu (%s) returned err=%d result=%" PRIi64 ", "
+                "recorded err=%d result=%" PRIi64,
+                get_instance_name(), i, StorageTrace_opName(rec->op),
+                err, result, rec->err, rec->result);
+
+            s->numMismatches++;
+        }
+    }
+
+    logStats(stats, tester_timer_getTimeUs() - startUs);
+    tester_stats_end("replay", appBytesWritten, NULL);
+
+    TEST_FINISH();
+}
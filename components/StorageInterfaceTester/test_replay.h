@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Replay of recorded storage I/O traces
+ *
+ * Plays back a trace captured by the StorageTraceRecorder against the storage
+ * under test and reports throughput and latency per operation. Requires the
+ * tester instance to be connected to a TimeServer and to the trace dataport.
+ */
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @brief   Waits for the trace to be completed and replays it.
+ *
+ * @param   honorTiming  if true, every request is issued at the same point of
+ *                       time relative to the start as in the recording,
+ *                       otherwise requests are issued as fast as possible.
+ */
+void test_replay_trace(bool honorTiming);
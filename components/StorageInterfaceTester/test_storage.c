@@ -9,11 +9,24 @@
 #include "test_storage.h"
 #include "system_config.h"
 #include "TestMacros.h"
+#include "StorageClient.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
 
 static const off_t storageBeginOffset = 0U;
 
+static const if_OS_Storage_t storage =
+    IF_OS_STORAGE_ASSIGN(
+        storage_rpc,
+        storage_port);
+
+// Only used for its cached geometry, the tests call the RPCs directly.
+static StorageClient_t storageClient;
+static bool            isStorageClientReady;
+
+static const OS_Dataport_t storagePort = OS_DATAPORT_ASSIGN(storage_port);
+
 /**
  * @brief   Random data used in the test.
  *
@@ -59,11 +72,12 @@ roundDownToBLockSize(
     const size_t roundedDownSize = roundDownToBLockSize(size); \
     size_t bytesWritten = 0U; \
 \
-    Debug_LOG_DEBUG( \
+    TESTER_LOG_DEBUG( \
         "%s::TEST_WRITE(" \
         "offset = %" PRIiMAX ", data = %p, size = %zu, " \
         "roundedDownSize = %zu)",  \
-        get_instance_name(), offset, data, size, roundedDownSize); \
+        get_instance_name(), (intmax_t)(offset), data, (size_t)(size), \
+        roundedDownSize); \
 \
     memcpy(storage_port, data, roundedDownSize); \
     TEST_SUCCESS( \
@@ -79,11 +93,12 @@ roundDownToBLockSize(
     const size_t roundedDownSize = roundDownToBLockSize(size); \
     size_t bytesRead = 0U; \
 \
-    Debug_LOG_DEBUG( \
+    TESTER_LOG_DEBUG( \
         "%s::TEST_READ(" \
         "offset = %" PRIiMAX ", expectedData = %p, size = %zu, " \
         "roundedDownSize = %zu)",  \
-        get_instance_name(), offset, expectedData, size, roundedDownSize); \
+        get_instance_name(), (intmax_t)(offset), expectedData, (size_t)(size), \
+        roundedDownSize); \
 \
     memset(storage_port, 0, roundedDownSize); \
     TEST_SUCCESS( \
@@ -105,10 +120,10 @@ roundDownToBLockSize(
 { \
     off_t bytesErased = -1; \
 \
-    Debug_LOG_DEBUG( \
+    TESTER_LOG_DEBUG( \
         "%s::TEST_ERASE(" \
         "offset = %" PRIiMAX ", size = %zu, ", \
-        get_instance_name(), offset, size); \
+        get_instance_name(), (intmax_t)(offset), (size_t)(size)); \
 \
     const OS_Error_t rslt = storage_rpc_erase( \
                                 roundDownToBLockSize(offset), \
@@ -165,7 +180,8 @@ test_storage_size_pos()
     off_t storageSize = 0U;
     TEST_SUCCESS(storage_rpc_getSize(&storageSize));
 
-    Debug_LOG_DEBUG("%s size is: %" PRIiMAX, get_instance_name(), storageSize);
+    TESTER_LOG_DEBUG(
+        "%s size is: %" PRIiMAX, get_instance_name(), (intmax_t)storageSize);
 
     ASSERT_LE_UINT64((off_t)(TEST_STORAGE_MIN_SIZE), storageSize);
 
@@ -180,7 +196,7 @@ test_storage_blockSize_pos()
     size_t storageBlockSize = 0U;
     TEST_SUCCESS(storage_rpc_getBlockSize(&storageBlockSize));
 
-    Debug_LOG_DEBUG(
+    TESTER_LOG_DEBUG(
         "%s block size is: %zu", get_instance_name(), storageBlockSize);
 
     // Different storages have different block sizes, but nevertheless the block
@@ -201,7 +217,7 @@ test_storage_state_pos()
     const OS_Error_t rslt = storage_rpc_getState(&flags);
 
     (void)rslt;
-    Debug_LOG_DEBUG(
+    TESTER_LOG_DEBUG(
         "%s::storage_rpc_getState(&flags). flags = %u, rslt = %i",
         get_instance_name(),
         flags,
@@ -380,11 +396,12 @@ test_storage_neighborRegionsUntouched_pos()
     const size_t roundedDownSize = roundDownToBLockSize(size); \
     size_t bytesWritten = (size_t)-1; \
 \
-    Debug_LOG_DEBUG( \
+    TESTER_LOG_DEBUG( \
         "%s::TEST_WRITE_NEG(" \
-        "offset = %" PRIiMAX ", size = %" PRIiMAX ")" \
+        "offset = %" PRIiMAX ", size = %" PRIiMAX ", " \
         "roundedDownSize = %zu)",  \
-        get_instance_name(), offset, size, roundedDownSize); \
+        get_instance_name(), (intmax_t)(offset), (intmax_t)(size), \
+        roundedDownSize); \
 \
     memcpy(storage_port, testData, TEST_DATA_SIZE); \
 \
@@ -399,11 +416,12 @@ test_storage_neighborRegionsUntouched_pos()
     const size_t roundedDownSize = roundDownToBLockSize(size); \
     size_t bytesRead = (size_t)-1; \
 \
-    Debug_LOG_DEBUG( \
+    TESTER_LOG_DEBUG( \
         "%s::TEST_READ_NEG(" \
-        "offset = %" PRIiMAX ", size = %" PRIiMAX ")" \
+        "offset = %" PRIiMAX ", size = %" PRIiMAX ", " \
         "roundedDownSize = %zu)",  \
-        get_instance_name(), offset, size, roundedDownSize); \
+        get_instance_name(), (intmax_t)(offset), (intmax_t)(size), \
+        roundedDownSize); \
 \
     memset(storage_port, 0, TEST_DATA_SIZE); \
     TEST_NOT_SUCCESS( \
@@ -416,10 +434,10 @@ test_storage_neighborRegionsUntouched_pos()
 { \
     off_t bytesErased = -1; \
 \
-    Debug_LOG_DEBUG( \
+    TESTER_LOG_DEBUG( \
         "%s::TEST_ERASE_NEG(" \
         "offset = %" PRIiMAX ", size = %" PRIiMAX ")", \
-        get_instance_name(), offset, size); \
+        get_instance_name(), (intmax_t)(offset), (intmax_t)(size)); \
 \
     TEST_NOT_SUCCESS( \
         storage_rpc_erase( \
@@ -442,12 +460,50 @@ test_storage_neighborRegionsUntouched_pos()
 } while (0)
 
 void
-test_storage_writeReadEraseLargerThanBuf_neg ()
+test_storage_writeReadEraseLargerThanBuf_neg()
 {
-    // Writing more bytes than the dataport size.
-    const off_t dataport_size = sizeof(storage_port) + TEST_DATA_SIZE;
+    TEST_START();
+
+    off_t storageSize = 0U;
+    TEST_SUCCESS(storage_rpc_getSize(&storageSize));
+
+    size_t storageBlockSize = 0U;
+    TEST_SUCCESS(storage_rpc_getBlockSize(&storageBlockSize));
+
+    // Writing and reading one block more than the dataport size, so that the
+    // size is still larger than the dataport after rounding it down to the
+    // block size.
+    const size_t size = roundDownToBLockSize(
+                            OS_Dataport_getSize(storagePort) + storageBlockSize);
 
-    TEST_WRITE_READ_ERASE_NEG(dataport_size, (off_t)TEST_DATA_SIZE);
+    // On a smaller storage the request would be rejected for being outside of
+    // it, which proves nothing about the dataport limit.
+    if ((off_t)size > storageSize)
+    {
+        TESTER_LOG_INFO(
+            "%s: storage of %" PRIiMAX " bytes is smaller than a request of "
+            "%zu bytes, skipped",
+            get_instance_name(), (intmax_t)storageSize, size);
+        TEST_FINISH();
+        return;
+    }
+
+    size_t bytesWritten = (size_t)-1;
+    memcpy(storage_port, testData, TEST_DATA_SIZE);
+    ASSERT_EQ_INT(
+        OS_ERROR_INVALID_PARAMETER,
+        storage_rpc_write(storageBeginOffset, size, &bytesWritten));
+    ASSERT_EQ_SZ((size_t)0U, bytesWritten);
+
+    size_t bytesRead = (size_t)-1;
+    ASSERT_EQ_INT(
+        OS_ERROR_INVALID_PARAMETER,
+        storage_rpc_read(storageBeginOffset, size, &bytesRead));
+    ASSERT_EQ_SZ((size_t)0U, bytesRead);
+
+    // Erasing does not use the dataport, so its size is no limit there.
+
+    TEST_FINISH();
 }
 
 void
@@ -513,19 +569,23 @@ off_t
 roundDownToBLockSize(
     off_t value)
 {
-    size_t storageBlockSize = 0U;
-    TEST_SUCCESS(storage_rpc_getBlockSize(&storageBlockSize));
+    // The geometry of the storage does not change, so it is queried only
+    // once and not for every rounded value.
+    if (!isStorageClientReady)
+    {
+        TEST_SUCCESS(StorageClient_init(&storageClient, &storage));
+        isStorageClientReady = true;
+    }
 
-    const off_t adjustedValue = (value / storageBlockSize)
-                                        * storageBlockSize;
+    const off_t adjustedValue = StorageClient_roundDown(&storageClient, value);
 
-    Debug_LOG_DEBUG(
+    TESTER_LOG_DEBUG(
         "%s: Adjusting given value to be aligned with the block size: "
         "value = %" PRIiMAX " "
         "adjustedValue = %" PRIiMAX,
         get_instance_name(),
-        value,
-        adjustedValue);
+        (intmax_t)value,
+        (intmax_t)adjustedValue);
 
     return adjustedValue;
 }
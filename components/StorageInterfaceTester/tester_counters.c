@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "tester_counters.h"
+#include "system_config.h"
+#include "TestMacros.h"
+#include "TimeServer.h"
+
+// ARM PMU event "instruction architecturally executed".
+#define PMU_EVENT_INST_RETIRED  0x08
+
+// PMCR bits
+#define PMCR_E                  (1u << 0)
+
+// PMCNTENSET bits, event counter 0 and the cycle counter
+#define PMCNTEN_EVENT0          (1u << 0)
+#define PMCNTEN_CYCLES          (1u << 31)
+
+static const if_OS_Timer_t timer =
+    IF_OS_TIMER_ASSIGN(
+        timeServer_rpc,
+        timeServer_notify);
+
+static int      activeSource = TESTER_CYCLES_OFF;
+static uint64_t counterMask  = UINT64_MAX;
+
+#if defined(TESTER_PMU_USER_ACCESS)
+
+/*
+ * The PMU is shared by all components on the core. Setting it up only enables
+ * the counters and selects the same event, so it does not disturb another
+ * tester counting at the same time. The counters are never reset.
+ */
+
+#if defined(__aarch64__)
+
+static void
+pmuInit(void)
+{
+    uint64_t pmcr;
+
+    __asm__ volatile("mrs %0, pmcr_el0" : "=r"(pmcr));
+    __asm__ volatile("msr pmevtyper0_el0, %0"
+                     :: "r"((uint64_t)PMU_EVENT_INST_RETIRED));
+    __asm__ volatile("msr pmcntenset_el0, %0"
+                     :: "r"((uint64_t)(PMCNTEN_EVENT0 | PMCNTEN_CYCLES)));
+    __asm__ volatile("msr pmcr_el0, %0"
+                     :: "r"(pmcr | PMCR_E));
+    __asm__ volatile("isb");
+}
+
+static void
+pmuRead(
+    TesterCounters_t* counters)
+{
+    uint64_t cycles, instructions;
+
+    __asm__ volatile("isb");
+    __asm__ volatile("mrs %0, pmccntr_el0" : "=r"(cycles));
+    __asm__ volatile("mrs %0, pmevcntr0_el0" : "=r"(instructions));
+
+    counters->cycles       = cycles;
+    // The event counters have 32 bits only.
+    counters->instructions = (uint32_t)instructions;
+}
+
+#elif defined(__arm__)
+
+static void
+pmuInit(void)
+{
+    uint32_t pmcr;
+
+    __asm__ volatile("mrc p15, 0, %0, c9, c12, 0" : "=r"(pmcr));
+    // Select event counter 0 and set its event.
+    __asm__ volatile("mcr p15, 0, %0, c9, c12, 5" :: "r"(0));
+    __asm__ volatile("mcr p15, 0, %0, c9, c13, 1"
+                     :: "r"(PMU_EVENT_INST_RETIRED));
+    __asm__ volatile("mcr p15, 0, %0, c9, c12, 1"
+                     :: "r"(PMCNTEN_EVENT0 | PMCNTEN_CYCLES));
+    __asm__ volatile("mcr p15, 0, %0, c9, c12, 0"
+                     :: "r"(pmcr | PMCR_E));
+    __asm__ volatile("isb");
+}
+
+static void
+pmuRead(
+    TesterCounters_t* counters)
+{
+    uint32_t cycles, instructions;
+
+    __asm__ volatile("isb");
+    __asm__ volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(cycles));
+    // Event counter 0 is still selected.
+    __asm__ volatile("mrc p15, 0, %0, c9, c13, 2" : "=r"(instructions));
+
+    counters->cycles       = cycles;
+    counters->instructions = instructions;
+}
+
+#else
+#error "TESTER_PMU_USER_ACCESS is only supported on ARM"
+#endif
+
+#endif /* TESTER_PMU_USER_ACCESS */
+
+bool
+tester_counters_init(int source)
+{
+    switch (source)
+    {
+    case TESTER_CYCLES_ICOUNT:
+        activeSource = source;
+        counterMask  = UINT64_MAX;
+        return true;
+
+#if defined(TESTER_PMU_USER_ACCESS)
+    case TESTER_CYCLES_PMU:
+        if (TESTER_CYCLES_PMU != activeSource)
+        {
+            pmuInit();
+        }
+        activeSource = source;
+        // The event counters have 32 bits, as has the cycle counter of ARMv7.
+        counterMask  = UINT32_MAX;
+        return true;
+#endif
+
+    default:
+        return false;
+    }
+}
+
+bool
+tester_counters_hasCycles()
+{
+    return (TESTER_CYCLES_PMU == activeSource);
+}
+
+void
+tester_counters_read(TesterCounters_t* counters)
+{
+#if defined(TESTER_PMU_USER_ACCESS)
+    if (TESTER_CYCLES_PMU == activeSource)
+    {
+        pmuRead(counters);
+        return;
+    }
+#endif
+
+    uint64_t ns = 0;
+
+    TEST_SUCCESS(TimeServer_getTime(&timer, TimeServer_PRECISION_NSEC, &ns));
+
+    counters->instructions = ns >> BENCH_CYCLES_ICOUNT_SHIFT;
+    counters->cycles       = 0;
+}
+
+TesterCounters_t
+tester_counters_diff(
+    const TesterCounters_t* start,
+    const TesterCounters_t* end)
+{
+    const TesterCounters_t diff =
+    {
+        .instructions = (end->instructions - start->instructions) & counterMask,
+        .cycles       = (end->cycles - start->cycles) & counterMask,
+    };
+
+    return diff;
+}
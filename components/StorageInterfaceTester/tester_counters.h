@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Instruction and cycle counters of the storage interface tester
+ *
+ * The counters come from one of the sources TESTER_CYCLES_xxx:
+ *
+ * - TESTER_CYCLES_ICOUNT: QEMU run with "-icount shift=N" advances its virtual
+ *   clock by 2^N ns per instruction, so the time of the TimeServer is an
+ *   instruction count. QEMU has no timing model, so there are no cycles.
+ * - TESTER_CYCLES_PMU: the cycle counter and an event counter of the ARM PMU,
+ *   which the kernel must export to user space (see STORAGE_TESTER_PMU in the
+ *   CMakeLists.txt).
+ *
+ * Both count everything done on the core, i.e. also the other components of
+ * the storage stack, the kernel and unrelated components running in between.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+    uint64_t instructions;
+    uint64_t cycles;
+} TesterCounters_t;
+
+/**
+ * @brief   Sets up the given counter source.
+ *
+ * @return  false if the source is not available in this build
+ */
+bool tester_counters_init(int source);
+
+/**
+ * @brief   Returns true if the source set up by tester_counters_init() counts
+ *          cycles, otherwise only the instructions are valid.
+ */
+bool tester_counters_hasCycles();
+
+/**
+ * @brief   Reads the counters of the source set up by tester_counters_init().
+ */
+void tester_counters_read(TesterCounters_t* counters);
+
+/**
+ * @brief   Returns the counts between two reads, taking into account that the
+ *          counters may be narrower than 64 bits and wrap around.
+ */
+TesterCounters_t tester_counters_diff(
+    const TesterCounters_t* start,
+    const TesterCounters_t* end);
@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "tester_log.h"
+#include "system_config.h"
+#include "TestMacros.h"
+
+LogBuffer_t tester_log;
+
+static LogBuffer_Entry_t entries[TESTER_LOG_NUM_ENTRIES];
+static char batch[SysLogger_Config_MSG_SIZE];
+
+void
+tester_log_init()
+{
+    TEST_SUCCESS(LogBuffer_init(&tester_log, entries, TESTER_LOG_NUM_ENTRIES));
+}
+
+void
+tester_log_flush()
+{
+    LogBuffer_flush(&tester_log, batch, sizeof(batch));
+}
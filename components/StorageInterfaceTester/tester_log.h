@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Deferred logging of the storage interface tester
+ *
+ * Messages logged on a measurement path, e.g. per request or per benchmark
+ * point, go through TESTER_LOG_xxx into a log buffer instead of an RPC to the
+ * SysLogger each. They are passed on to the SysLogger by tester_log_flush(),
+ * which TEST_FINISH() and failing assertions call.
+ */
+#pragma once
+
+#include "LogBuffer.h"
+
+extern LogBuffer_t tester_log;
+
+#define TESTER_LOG_ERROR(...)   LogBuffer_LOG_ERROR(&tester_log, __VA_ARGS__)
+#define TESTER_LOG_WARNING(...) LogBuffer_LOG_WARNING(&tester_log, __VA_ARGS__)
+#define TESTER_LOG_INFO(...)    LogBuffer_LOG_INFO(&tester_log, __VA_ARGS__)
+#define TESTER_LOG_DEBUG(...)   LogBuffer_LOG_DEBUG(&tester_log, __VA_ARGS__)
+
+/**
+ * @brief   Sets up the log buffer, must be called before any TESTER_LOG_xxx.
+ */
+void tester_log_init();
+
+/**
+ * @brief   Passes the buffered messages on to the SysLogger.
+ */
+void tester_log_flush();
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "tester_stats.h"
+#include "OS_Dataport.h"
+#include "TestMacros.h"
+
+static const OS_Dataport_t statsPort = OS_DATAPORT_ASSIGN(stats_port);
+
+bool
+tester_stats_isAvailable()
+{
+    return (0 != has_stats);
+}
+
+void
+tester_stats_begin()
+{
+    if (!tester_stats_isAvailable())
+    {
+        return;
+    }
+
+    TEST_SUCCESS(stats_rpc_reset());
+}
+
+void
+tester_stats_end(
+    const char*     name,
+    uint64_t        appBytesWritten,
+    StorageStats_t* stats)
+{
+    StorageStats_t s;
+
+    if (!tester_stats_isAvailable())
+    {
+        return;
+    }
+
+    TEST_SUCCESS(stats_rpc_get());
+    memcpy(&s, OS_Dataport_getBuf(statsPort), sizeof(s));
+
+    TESTER_LOG_INFO(
+        "%s: %s backend ops w/r/e=%" PRIu64 "/%" PRIu64 "/%" PRIu64 " "
+        "bytes w/r/e=%" PRIu64 "/%" PRIu64 "/%" PRIu64 " errors=%" PRIu64,
+        get_instance_name(), name,
+        s.numWrites, s.numReads, s.numErases,
+        s.bytesWritten, s.bytesRead, s.bytesErased,
+        s.numErrors);
+
+    // Utilization and write amplification in percent.
+    TESTER_LOG_INFO(
+        "%s: %s backend busy=%" PRIu64 " us of %" PRIu64 " us "
+        "(utilization %" PRIu64 "%%), max latency=%" PRIu64 " us, "
+        "write amplification %" PRIu64 "%%",
+        get_instance_name(), name,
+        s.busyUs, s.periodUs,
+        (s.periodUs > 0) ? (s.busyUs * 100) / s.periodUs : 0,
+        s.maxLatencyUs,
+        (appBytesWritten > 0) ? (s.bytesWritten * 100) / appBytesWritten : 0);
+
+    if (NULL != stats)
+    {
+        *stats = s;
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Backend statistics snapshots of the storage interface tester
+ *
+ * Benchmarks wrap their measurement with tester_stats_begin() and
+ * tester_stats_end() to also get the backend's view of the workload. Both are
+ * no-ops for tester instances without a connected if_StorageStats.
+ */
+#pragma once
+
+#include "StorageStats.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief   Returns true if this tester instance has backend statistics.
+ */
+bool tester_stats_isAvailable();
+
+/**
+ * @brief   Resets the backend statistics, starting a new measurement period.
+ */
+void tester_stats_begin();
+
+/**
+ * @brief   Fetches and logs the backend statistics of the measurement period.
+ *
+ * @param   name            name of the benchmark for the log
+ * @param   appBytesWritten bytes written by the benchmark, used to compute the
+ *                          write amplification (0 to skip it)
+ * @param   stats           optional, receives the fetched statistics
+ */
+void tester_stats_end(
+    const char*     name,
+    uint64_t        appBytesWritten,
+    StorageStats_t* stats);
@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "tester_timer.h"
+#include "TestMacros.h"
+#include "TimeServer.h"
+
+static const if_OS_Timer_t timer =
+    IF_OS_TIMER_ASSIGN(
+        timeServer_rpc,
+        timeServer_notify);
+
+uint64_t
+tester_timer_getTimeUs()
+{
+    uint64_t now = 0;
+
+    TEST_SUCCESS(TimeServer_getTime(&timer, TimeServer_PRECISION_USEC, &now));
+
+    return now;
+}
+
+void
+tester_timer_sleepUs(uint64_t us)
+{
+    TEST_SUCCESS(TimeServer_sleep(&timer, TimeServer_PRECISION_USEC, us));
+}
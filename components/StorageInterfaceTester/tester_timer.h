@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Time measurement helpers of the storage interface tester
+ *
+ * Only available in tester instances connected to a TimeServer.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief   Returns the current time in microseconds.
+ */
+uint64_t tester_timer_getTimeUs();
+
+/**
+ * @brief   Blocks the calling thread for the given time in microseconds.
+ */
+void tester_timer_sleepUs(uint64_t us);
@@ -0,0 +1,388 @@
+/*
+ * Storage latency shim
+ *
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "OS_Error.h"
+#include "OS_Dataport.h"
+#include "TimeServer.h"
+#include "SysLoggerClient.h"
+#include "BootTiming.h"
+#include "lib_compiler/compiler.h"
+#include "lib_debug/Debug.h"
+
+#include <camkes.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+typedef enum
+{
+    JITTER_NONE     = 0,
+    JITTER_UNIFORM  = 1,
+    JITTER_BELL     = 2,
+} JitterMode_t;
+
+typedef struct
+{
+    uint64_t fixedUs;
+    uint64_t nsPerKiB;
+} OpLatency_t;
+
+static const if_OS_Timer_t timer =
+    IF_OS_TIMER_ASSIGN(
+        timeServer_rpc,
+        timeServer_notify);
+
+static const OS_Dataport_t clientPort  = OS_DATAPORT_ASSIGN(storage_port);
+static const OS_Dataport_t backendPort = OS_DATAPORT_ASSIGN(backend_port);
+
+static struct
+{
+    OpLatency_t read;
+    OpLatency_t write;
+    OpLatency_t erase;
+    uint32_t    rngState;
+    uint64_t    stallCounter;
+    bool        isBackendReady;
+    bool        hadRequest;
+    off_t       backendSize;
+    size_t      backendBlockSize;
+} ctx;
+
+
+//------------------------------------------------------------------------------
+// xorshift32, good enough for jitter and fully reproducible for a given seed.
+static uint32_t
+nextRandom(void)
+{
+    uint32_t x = ctx.rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    ctx.rngState = x;
+    return x;
+}
+
+
+//------------------------------------------------------------------------------
+static uint64_t
+jitterUs(void)
+{
+    const uint64_t range = (uint64_t)jitter_us + 1;
+
+    if ((jitter_us <= 0) || (JITTER_NONE == jitter_mode))
+    {
+        return 0;
+    }
+
+    if (JITTER_BELL == jitter_mode)
+    {
+        // Irwin-Hall approximation of a normal distribution centered in the
+        // middle of the range.
+        uint64_t sum = 0;
+        for (unsigned int i = 0; i < 4; i++)
+        {
+            sum += nextRandom() % range;
+        }
+        return sum / 4;
+    }
+
+    return nextRandom() % range;
+}
+
+
+//------------------------------------------------------------------------------
+static uint64_t
+stallUs(void)
+{
+    if (stall_every_ops <= 0)
+    {
+        return 0;
+    }
+
+    return (0 == (++ctx.stallCounter % stall_every_ops)) ? stall_us : 0;
+}
+
+
+//------------------------------------------------------------------------------
+// Number of erase blocks touched by [offset, offset + size) which are not
+// fully covered by it.
+static uint64_t
+partialEraseBlocks(
+    off_t  offset,
+    size_t size)
+{
+    if ((erase_block_size <= 0) || (0 == size))
+    {
+        return 0;
+    }
+
+    const off_t  ebs   = erase_block_size;
+    const off_t  end   = offset + size;
+    const bool   head  = (0 != (offset % ebs));
+    const bool   tail  = (0 != (end % ebs));
+
+    // Both ends fall into the same, partially written erase block.
+    if ((offset / ebs) == ((end - 1) / ebs))
+    {
+        return (head || tail) ? 1 : 0;
+    }
+
+    return (head ? 1 : 0) + (tail ? 1 : 0);
+}
+
+
+//------------------------------------------------------------------------------
+static uint64_t
+getTimeUs(void)
+{
+    uint64_t now = 0;
+
+    const OS_Error_t err = TimeServer_getTime(
+                               &timer,
+                               TimeServer_PRECISION_USEC,
+                               &now);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("TimeServer_getTime() failed with %d", err);
+    }
+
+    return now;
+}
+
+
+//------------------------------------------------------------------------------
+// The geometry never changes, so it is fetched from the backend only once, with
+// the first geometry query. Data requests do not need it and are forwarded
+// without it, so an error of the backend is reported as the backend reports it.
+static OS_Error_t
+initBackend(void)
+{
+    OS_Error_t err;
+
+    if (ctx.isBackendReady)
+    {
+        return OS_SUCCESS;
+    }
+
+    if ((err = backend_rpc_getSize(&ctx.backendSize)) != OS_SUCCESS)
+    {
+        return err;
+    }
+    if ((err = backend_rpc_getBlockSize(&ctx.backendBlockSize)) != OS_SUCCESS)
+    {
+        return err;
+    }
+
+    ctx.isBackendReady = true;
+    BootTiming_LOG("backend ready", getTimeUs());
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+static void
+markFirstRequest(void)
+{
+    if (!ctx.hadRequest)
+    {
+        ctx.hadRequest = true;
+        BootTiming_LOG("first request", getTimeUs());
+    }
+}
+
+
+//------------------------------------------------------------------------------
+static void
+injectLatency(
+    const OpLatency_t* latency,
+    uint64_t           size,
+    uint64_t           extraUs)
+{
+    const uint64_t delayUs = latency->fixedUs
+                             + ((size * latency->nsPerKiB) / (1024 * 1000))
+                             + jitterUs()
+                             + extraUs;
+    if (0 == delayUs)
+    {
+        return;
+    }
+
+    const OS_Error_t err = TimeServer_sleep(
+                               &timer,
+                               TimeServer_PRECISION_USEC,
+                               delayUs);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("TimeServer_sleep() failed with %d", err);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+void
+post_init(void)
+{
+    DECL_UNUSED_VAR(OS_Error_t err) = SysLoggerClient_init(sysLogger_Rpc_log);
+    Debug_ASSERT(err == OS_SUCCESS);
+
+    ctx.read.fixedUs   = read_fixed_us;
+    ctx.read.nsPerKiB  = read_ns_per_kib;
+    ctx.write.fixedUs  = write_fixed_us;
+    ctx.write.nsPerKiB = write_ns_per_kib;
+    ctx.erase.fixedUs  = erase_fixed_us;
+    ctx.erase.nsPerKiB = erase_ns_per_kib;
+
+    // xorshift must never be seeded with zero.
+    ctx.rngState = (0 != jitter_seed) ? (uint32_t)jitter_seed : 1;
+
+    Debug_LOG_DEBUG(
+        "%s: read %d us + %d ns/KiB, write %d us + %d ns/KiB, "
+        "erase %d us + %d ns/KiB, jitter mode %d up to %d us, "
+        "stall %d us every %d ops, erase block %d bytes penalty %d us",
+        get_instance_name(),
+        read_fixed_us, read_ns_per_kib,
+        write_fixed_us, write_ns_per_kib,
+        erase_fixed_us, erase_ns_per_kib,
+        jitter_mode, jitter_us,
+        stall_us, stall_every_ops,
+        erase_block_size, erase_block_penalty_us);
+}
+
+
+//------------------------------------------------------------------------------
+// if_OS_Storage
+//------------------------------------------------------------------------------
+
+OS_Error_t
+NONNULL_ALL
+storage_rpc_write(
+    off_t   offset,
+    size_t  size,
+    size_t* written)
+{
+    *written = 0;
+
+    markFirstRequest();
+
+    if ((size > OS_Dataport_getSize(clientPort))
+        || (size > OS_Dataport_getSize(backendPort)))
+    {
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    memcpy(
+        OS_Dataport_getBuf(backendPort),
+        OS_Dataport_getBuf(clientPort),
+        size);
+
+    const OS_Error_t err = backend_rpc_write(offset, size, written);
+
+    injectLatency(
+        &ctx.write,
+        *written,
+        stallUs() + (partialEraseBlocks(offset, *written)
+                     * (uint64_t)erase_block_penalty_us));
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_read(
+    off_t   offset,
+    size_t  size,
+    size_t* read)
+{
+    *read = 0;
+
+    markFirstRequest();
+
+    if ((size > OS_Dataport_getSize(clientPort))
+        || (size > OS_Dataport_getSize(backendPort)))
+    {
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    const OS_Error_t err = backend_rpc_read(offset, size, read);
+
+    memcpy(
+        OS_Dataport_getBuf(clientPort),
+        OS_Dataport_getBuf(backendPort),
+        *read);
+
+    injectLatency(&ctx.read, *read, 0);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_erase(
+    off_t  offset,
+    off_t  size,
+    off_t* erased)
+{
+    *erased = 0;
+
+    markFirstRequest();
+
+    const OS_Error_t err = backend_rpc_erase(offset, size, erased);
+
+    injectLatency(&ctx.erase, (*erased > 0) ? *erased : 0, stallUs());
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getSize(
+    off_t* const size)
+{
+    markFirstRequest();
+
+    const OS_Error_t err = initBackend();
+    *size = ctx.backendSize;
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getBlockSize(
+    size_t* const blockSize)
+{
+    markFirstRequest();
+
+    const OS_Error_t err = initBackend();
+    *blockSize = ctx.backendBlockSize;
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getState(
+    uint32_t* flags)
+{
+    // The state is not part of the cached geometry and must not depend on a
+    // working backend, so it is always forwarded.
+    markFirstRequest();
+
+    return backend_rpc_getState(flags);
+}
@@ -0,0 +1,302 @@
+/*
+ * Storage layer benchmark
+ *
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "system_config.h"
+
+#include "OS_Error.h"
+#include "OS_Dataport.h"
+#include "interfaces/if_OS_Storage.h"
+#include "TimeServer.h"
+#include "SysLoggerClient.h"
+#include "lib_compiler/compiler.h"
+#include "lib_debug/Debug.h"
+
+#include <camkes.h>
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define LAYER_PATTERN   0x96
+
+typedef enum
+{
+    LAYER_OP_GET_SIZE,
+    LAYER_OP_WRITE,
+    LAYER_OP_READ,
+    LAYER_OP_ERASE,
+} LayerOp_t;
+
+typedef struct
+{
+    const if_OS_Storage_t*  storage;
+    const char*             name;
+    off_t                   storageSize;
+    bool                    isEraseSupported;
+} Path_t;
+
+typedef struct
+{
+    uint64_t totalUs;
+    uint64_t minUs;
+} PathTiming_t;
+
+static const if_OS_Timer_t timer =
+    IF_OS_TIMER_ASSIGN(
+        timeServer_rpc,
+        timeServer_notify);
+
+static const if_OS_Storage_t directStorage =
+    IF_OS_STORAGE_ASSIGN(
+        direct_rpc,
+        direct_port);
+
+static const if_OS_Storage_t layeredStorage =
+    IF_OS_STORAGE_ASSIGN(
+        layered_rpc,
+        layered_port);
+
+static Path_t paths[] =
+{
+    { &directStorage,  "direct"  },
+    { &layeredStorage, "layered" },
+};
+
+static const struct
+{
+    LayerOp_t   op;
+    const char* name;
+} ops[] =
+{
+    // getSize() moves no data, so it shows the pure cost of the RPCs.
+    { LAYER_OP_GET_SIZE, "getSize" },
+    { LAYER_OP_WRITE,    "write"   },
+    { LAYER_OP_READ,     "read"    },
+    { LAYER_OP_ERASE,    "erase"   },
+};
+
+static const size_t sizes[] = { 64, 512, 4096 };
+
+
+//------------------------------------------------------------------------------
+static uint64_t
+getTimeUs(void)
+{
+    uint64_t now = 0;
+
+    const OS_Error_t err = TimeServer_getTime(
+                               &timer,
+                               TimeServer_PRECISION_USEC,
+                               &now);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("TimeServer_getTime() failed with %d", err);
+    }
+
+    return now;
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+issueOp(
+    const Path_t*   path,
+    LayerOp_t       op,
+    off_t           offset,
+    size_t          size,
+    uint64_t*       us)
+{
+    const if_OS_Storage_t* storage = path->storage;
+    size_t processed = 0;
+    off_t  erased    = 0;
+    off_t  storageSize;
+    OS_Error_t err;
+
+    const uint64_t startUs = getTimeUs();
+
+    switch (op)
+    {
+    case LAYER_OP_GET_SIZE:
+        err = storage->getSize(&storageSize);
+        processed = size;
+        break;
+    case LAYER_OP_WRITE:
+        err = storage->write(offset, size, &processed);
+        break;
+    case LAYER_OP_READ:
+        err = storage->read(offset, size, &processed);
+        break;
+    default:
+        err = storage->erase(offset, size, &erased);
+        processed = erased;
+        break;
+    }
+
+    *us = getTimeUs() - startUs;
+
+    if (OS_SUCCESS != err)
+    {
+        return err;
+    }
+
+    return (processed == size) ? OS_SUCCESS : OS_ERROR_GENERIC;
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+measure(
+    LayerOp_t       op,
+    const char*     opName,
+    size_t          size)
+{
+    PathTiming_t timings[ARRAY_SIZE(paths)];
+    memset(timings, 0, sizeof(timings));
+
+    const off_t numSlots = ((paths[0].storageSize < paths[1].storageSize)
+                            ? paths[0].storageSize : paths[1].storageSize)
+                           / size;
+
+    for (unsigned int i = 0; i < LAYER_BENCH_REPETITIONS; i++)
+    {
+        const off_t offset = (i % numSlots) * size;
+
+        // Every request goes to both paths, alternating which one is first,
+        // so both see the same state of the system.
+        for (unsigned int n = 0; n < ARRAY_SIZE(paths); n++)
+        {
+            const unsigned int p = (n + i) % ARRAY_SIZE(paths);
+            uint64_t us = 0;
+
+            const OS_Error_t err = issueOp(&paths[p], op, offset, size, &us);
+            if (OS_SUCCESS != err)
+            {
+                Debug_LOG_ERROR(
+                    "%s %zu bytes on %s path failed with %d",
+                    opName, size, paths[p].name, err);
+                return err;
+            }
+
+            timings[p].totalUs += us;
+            timings[p].minUs    = ((0 == i) || (us < timings[p].minUs))
+                                  ? us : timings[p].minUs;
+        }
+    }
+
+    const uint64_t directAvgUs  = timings[0].totalUs / LAYER_BENCH_REPETITIONS;
+    const uint64_t layeredAvgUs = timings[1].totalUs / LAYER_BENCH_REPETITIONS;
+    const int64_t  overheadUs   = (int64_t)layeredAvgUs - (int64_t)directAvgUs;
+
+    Debug_LOG_INFO(
+        "%s: %-7s size=%-5zu direct avg/min=%" PRIu64 "/%" PRIu64 " us, "
+        "layered avg/min=%" PRIu64 "/%" PRIu64 " us, "
+        "overhead avg=%" PRIi64 " us (%" PRIi64 "%%), min=%" PRIi64 " us",
+        get_instance_name(),
+        opName,
+        size,
+        directAvgUs,
+        timings[0].minUs,
+        layeredAvgUs,
+        timings[1].minUs,
+        overheadUs,
+        (directAvgUs > 0) ? (overheadUs * 100) / (int64_t)directAvgUs : 0,
+        (int64_t)timings[1].minUs - (int64_t)timings[0].minUs);
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+preparePath(
+    Path_t* path)
+{
+    OS_Error_t err;
+
+    if ((err = path->storage->getSize(&path->storageSize)) != OS_SUCCESS)
+    {
+        Debug_LOG_ERROR("getSize() of %s path failed with %d", path->name, err);
+        return err;
+    }
+
+    memset(
+        OS_Dataport_getBuf(path->storage->dataport),
+        LAYER_PATTERN,
+        OS_Dataport_getSize(path->storage->dataport));
+
+    off_t erased = 0;
+    err = path->storage->erase(0, 0, &erased);
+    path->isEraseSupported = (OS_ERROR_NOT_IMPLEMENTED != err);
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+int
+run()
+{
+    DECL_UNUSED_VAR(OS_Error_t err) = SysLoggerClient_init(sysLogger_Rpc_log);
+    Debug_ASSERT(err == OS_SUCCESS);
+
+    for (size_t p = 0; p < ARRAY_SIZE(paths); p++)
+    {
+        if (preparePath(&paths[p]) != OS_SUCCESS)
+        {
+            return -1;
+        }
+    }
+
+    for (size_t o = 0; o < ARRAY_SIZE(ops); o++)
+    {
+        if ((LAYER_OP_ERASE == ops[o].op)
+            && !(paths[0].isEraseSupported && paths[1].isEraseSupported))
+        {
+            Debug_LOG_INFO(
+                "%s: erase is not implemented on both paths, skipped",
+                get_instance_name());
+            continue;
+        }
+
+        for (size_t s = 0; s < ARRAY_SIZE(sizes); s++)
+        {
+            const size_t size = sizes[s];
+
+            if ((size > OS_Dataport_getSize(paths[0].storage->dataport))
+                || (size > OS_Dataport_getSize(paths[1].storage->dataport))
+                || ((off_t)size > paths[0].storageSize)
+                || ((off_t)size > paths[1].storageSize))
+            {
+                continue;
+            }
+
+            if (measure(ops[o].op, ops[o].name, size) != OS_SUCCESS)
+            {
+                Debug_LOG_ERROR(
+                    "%s -> !!! Benchmark of %s failed.",
+                    get_instance_name(),
+                    ops[o].name);
+                return -1;
+            }
+
+            // getSize() does not depend on the size.
+            if (LAYER_OP_GET_SIZE == ops[o].op)
+            {
+                break;
+            }
+        }
+    }
+
+    Debug_LOG_INFO(
+        "%s -> !!! All benchmarks successfully completed.",
+        get_instance_name());
+
+    return 0;
+}
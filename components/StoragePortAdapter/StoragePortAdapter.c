@@ -0,0 +1,152 @@
+/*
+ * Storage dataport adapter
+ *
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "OS_Error.h"
+#include "OS_Dataport.h"
+#include "lib_compiler/compiler.h"
+
+#include <camkes.h>
+
+#include <stdint.h>
+#include <string.h>
+
+static const OS_Dataport_t clientPort  = OS_DATAPORT_ASSIGN(storage_port);
+static const OS_Dataport_t backendPort = OS_DATAPORT_ASSIGN(backend_port);
+
+
+//------------------------------------------------------------------------------
+static size_t
+getChunkSize(
+    size_t remaining)
+{
+    const size_t backendSize = OS_Dataport_getSize(backendPort);
+
+    return (remaining < backendSize) ? remaining : backendSize;
+}
+
+
+//------------------------------------------------------------------------------
+// if_OS_Storage
+//
+// The forwarding of a request stops at the first backend request which fails
+// or is processed only partially.
+//------------------------------------------------------------------------------
+
+OS_Error_t
+NONNULL_ALL
+storage_rpc_write(
+    off_t   offset,
+    size_t  size,
+    size_t* written)
+{
+    const uint8_t* const src = OS_Dataport_getBuf(clientPort);
+    OS_Error_t err;
+    size_t chunk;
+    size_t done;
+
+    *written = 0;
+
+    if (size > OS_Dataport_getSize(clientPort))
+    {
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    do
+    {
+        chunk = getChunkSize(size - *written);
+        done  = 0;
+
+        memcpy(OS_Dataport_getBuf(backendPort), &src[*written], chunk);
+
+        err = backend_rpc_write(offset + *written, chunk, &done);
+        *written += done;
+    }
+    while ((OS_SUCCESS == err) && (done == chunk) && (*written < size));
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_read(
+    off_t   offset,
+    size_t  size,
+    size_t* read)
+{
+    uint8_t* const dst = OS_Dataport_getBuf(clientPort);
+    OS_Error_t err;
+    size_t chunk;
+    size_t done;
+
+    *read = 0;
+
+    if (size > OS_Dataport_getSize(clientPort))
+    {
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    do
+    {
+        chunk = getChunkSize(size - *read);
+        done  = 0;
+
+        err = backend_rpc_read(offset + *read, chunk, &done);
+
+        memcpy(&dst[*read], OS_Dataport_getBuf(backendPort), done);
+        *read += done;
+    }
+    while ((OS_SUCCESS == err) && (done == chunk) && (*read < size));
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_erase(
+    off_t  offset,
+    off_t  size,
+    off_t* erased)
+{
+    return backend_rpc_erase(offset, size, erased);
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getSize(
+    off_t* const size)
+{
+    return backend_rpc_getSize(size);
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getBlockSize(
+    size_t* const blockSize)
+{
+    return backend_rpc_getBlockSize(blockSize);
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getState(
+    uint32_t* flags)
+{
+    return backend_rpc_getState(flags);
+}
@@ -0,0 +1,294 @@
+/*
+ * RAM based storage
+ *
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "OS_Error.h"
+#include "OS_Dataport.h"
+#include "system_config.h"
+#include "lib_compiler/compiler.h"
+#include "lib_debug/Debug.h"
+
+#include <camkes.h>
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Like the RamDisk of the SDK, the storage can be accessed bytewise.
+#define BLOCK_SIZE      1
+#define ERASED_PATTERN  0xFF
+
+// Erased units are only marked in a bitmap instead of being filled with the
+// ERASED_PATTERN, reads of them return the pattern. A unit is filled only
+// when it is partially written. Partially erased units are filled directly.
+#define UNIT_SIZE       STORAGE_RAMDISK_ERASE_UNIT_SIZE
+#define NUM_UNITS       (STORAGE_RAMDISK_SIZE / UNIT_SIZE)
+#define BITS_PER_WORD   32
+
+static_assert(
+    0 == (STORAGE_RAMDISK_SIZE % UNIT_SIZE),
+    "Storage size must be a multiple of the erase unit size");
+
+static const OS_Dataport_t port = OS_DATAPORT_ASSIGN(storage_port);
+
+static uint8_t  storage[STORAGE_RAMDISK_SIZE];
+static uint32_t erasedUnits[(NUM_UNITS + BITS_PER_WORD - 1) / BITS_PER_WORD];
+
+
+//------------------------------------------------------------------------------
+static bool
+isValidRange(
+    off_t offset,
+    off_t size)
+{
+    return (offset >= 0)
+           && (size >= 0)
+           && (offset <= STORAGE_RAMDISK_SIZE)
+           && (size <= (STORAGE_RAMDISK_SIZE - offset));
+}
+
+
+//------------------------------------------------------------------------------
+static bool
+isErased(
+    size_t unit)
+{
+    return erasedUnits[unit / BITS_PER_WORD] & (1U << (unit % BITS_PER_WORD));
+}
+
+
+//------------------------------------------------------------------------------
+// Sets or clears the erased bit of the units [first, end), whole words of the
+// bitmap at once.
+static void
+markUnits(
+    size_t first,
+    size_t end,
+    bool   erased)
+{
+    size_t unit = first;
+
+    while (unit < end)
+    {
+        const size_t word = unit / BITS_PER_WORD;
+
+        if ((0 == (unit % BITS_PER_WORD)) && ((end - unit) >= BITS_PER_WORD))
+        {
+            const size_t numWords = (end - unit) / BITS_PER_WORD;
+
+            memset(
+                &erasedUnits[word],
+                erased ? 0xFF : 0,
+                numWords * sizeof(erasedUnits[0]));
+            unit += numWords * BITS_PER_WORD;
+        }
+        else
+        {
+            const uint32_t bit = 1U << (unit % BITS_PER_WORD);
+
+            erasedUnits[word] = erased
+                                ? (erasedUnits[word] | bit)
+                                : (erasedUnits[word] & ~bit);
+            unit++;
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+// Makes the content of an erased unit real before it is partially written.
+static void
+fillUnit(
+    size_t unit)
+{
+    if (isErased(unit))
+    {
+        memset(&storage[unit * UNIT_SIZE], ERASED_PATTERN, UNIT_SIZE);
+        markUnits(unit, unit + 1, false);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+void
+post_init(void)
+{
+    markUnits(0, NUM_UNITS, true);
+
+    Debug_LOG_DEBUG(
+        "%s: %zu bytes, dataport of %zu bytes",
+        get_instance_name(),
+        sizeof(storage),
+        OS_Dataport_getSize(port));
+}
+
+
+//------------------------------------------------------------------------------
+// if_OS_Storage
+//------------------------------------------------------------------------------
+
+OS_Error_t
+NONNULL_ALL
+storage_rpc_write(
+    off_t   offset,
+    size_t  size,
+    size_t* written)
+{
+    *written = 0;
+
+    if ((size > OS_Dataport_getSize(port)) || !isValidRange(offset, size))
+    {
+        Debug_LOG_ERROR(
+            "%s: invalid write, offset = %" PRIiMAX ", size = %zu",
+            get_instance_name(), (intmax_t)offset, size);
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    if (size > 0)
+    {
+        const size_t first = offset / UNIT_SIZE;
+        const size_t last  = (offset + size - 1) / UNIT_SIZE;
+
+        // Only the first and the last unit can be written partially, all the
+        // others are overwritten completely and just lose their erased state.
+        fillUnit(first);
+        fillUnit(last);
+        markUnits(first, last + 1, false);
+
+        memcpy(&storage[offset], OS_Dataport_getBuf(port), size);
+    }
+
+    *written = size;
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_read(
+    off_t   offset,
+    size_t  size,
+    size_t* read)
+{
+    *read = 0;
+
+    if ((size > OS_Dataport_getSize(port)) || !isValidRange(offset, size))
+    {
+        Debug_LOG_ERROR(
+            "%s: invalid read, offset = %" PRIiMAX ", size = %zu",
+            get_instance_name(), (intmax_t)offset, size);
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    uint8_t* const buf = OS_Dataport_getBuf(port);
+    const off_t    end = offset + size;
+    off_t          pos = offset;
+
+    while (pos < end)
+    {
+        const size_t unit    = pos / UNIT_SIZE;
+        const off_t  unitEnd = (unit + 1) * UNIT_SIZE;
+        const size_t len     = ((end < unitEnd) ? end : unitEnd) - pos;
+
+        if (isErased(unit))
+        {
+            memset(&buf[pos - offset], ERASED_PATTERN, len);
+        }
+        else
+        {
+            memcpy(&buf[pos - offset], &storage[pos], len);
+        }
+
+        pos += len;
+    }
+
+    *read = size;
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_erase(
+    off_t  offset,
+    off_t  size,
+    off_t* erased)
+{
+    *erased = 0;
+
+    if (!isValidRange(offset, size))
+    {
+        Debug_LOG_ERROR(
+            "%s: invalid erase, offset = %" PRIiMAX ", size = %" PRIiMAX,
+            get_instance_name(), (intmax_t)offset, (intmax_t)size);
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    const off_t end       = offset + size;
+    const off_t firstFull = ((offset + UNIT_SIZE - 1) / UNIT_SIZE) * UNIT_SIZE;
+    const off_t endFull   = (end / UNIT_SIZE) * UNIT_SIZE;
+
+    if (firstFull < endFull)
+    {
+        // The parts of units at the edges are filled, the units in between
+        // are only marked as erased.
+        memset(&storage[offset], ERASED_PATTERN, firstFull - offset);
+        memset(&storage[endFull], ERASED_PATTERN, end - endFull);
+        markUnits(firstFull / UNIT_SIZE, endFull / UNIT_SIZE, true);
+    }
+    else
+    {
+        memset(&storage[offset], ERASED_PATTERN, size);
+    }
+
+    *erased = size;
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getSize(
+    off_t* const size)
+{
+    *size = STORAGE_RAMDISK_SIZE;
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getBlockSize(
+    size_t* const blockSize)
+{
+    *blockSize = BLOCK_SIZE;
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getState(
+    uint32_t* flags)
+{
+    *flags = 0U;
+
+    return OS_SUCCESS;
+}
@@ -0,0 +1,294 @@
+/*
+ * Storage statistics probe
+ *
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "OS_Error.h"
+#include "OS_Dataport.h"
+#include "TimeServer.h"
+#include "SysLoggerClient.h"
+#include "BootTiming.h"
+#include "StorageStats.h"
+#include "lib_compiler/compiler.h"
+#include "lib_debug/Debug.h"
+
+#include <camkes.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+typedef enum
+{
+    OP_WRITE,
+    OP_READ,
+    OP_ERASE,
+    OP_OTHER
+} Op_t;
+
+static const if_OS_Timer_t timer =
+    IF_OS_TIMER_ASSIGN(
+        timeServer_rpc,
+        timeServer_notify);
+
+static const OS_Dataport_t clientPort  = OS_DATAPORT_ASSIGN(storage_port);
+static const OS_Dataport_t backendPort = OS_DATAPORT_ASSIGN(backend_port);
+static const OS_Dataport_t statsPort   = OS_DATAPORT_ASSIGN(stats_port);
+
+static StorageStats_t stats;
+// Start of the measurement period, 0 until the first request or reset.
+static uint64_t       resetUs;
+static bool           hadRequest;
+
+
+//------------------------------------------------------------------------------
+static uint64_t
+getTimeUs(void)
+{
+    uint64_t now = 0;
+
+    const OS_Error_t err = TimeServer_getTime(
+                               &timer,
+                               TimeServer_PRECISION_USEC,
+                               &now);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("TimeServer_getTime() failed with %d", err);
+    }
+
+    return now;
+}
+
+
+//------------------------------------------------------------------------------
+static void
+account(
+    Op_t       op,
+    uint64_t   bytes,
+    OS_Error_t err,
+    uint64_t   startUs)
+{
+    const uint64_t latencyUs = getTimeUs() - startUs;
+
+    stats_mutex_lock();
+
+    if (!hadRequest)
+    {
+        hadRequest = true;
+        BootTiming_LOG("first request", startUs);
+    }
+
+    if (0 == resetUs)
+    {
+        resetUs = startUs;
+    }
+
+    switch (op)
+    {
+    case OP_WRITE:
+        stats.numWrites++;
+        stats.bytesWritten += bytes;
+        break;
+    case OP_READ:
+        stats.numReads++;
+        stats.bytesRead += bytes;
+        break;
+    case OP_ERASE:
+        stats.numErases++;
+        stats.bytesErased += bytes;
+        break;
+    default:
+        break;
+    }
+
+    if (OS_SUCCESS != err)
+    {
+        stats.numErrors++;
+    }
+
+    stats.busyUs += latencyUs;
+    if (latencyUs > stats.maxLatencyUs)
+    {
+        stats.maxLatencyUs = latencyUs;
+    }
+
+    stats_mutex_unlock();
+}
+
+
+//------------------------------------------------------------------------------
+void
+post_init(void)
+{
+    DECL_UNUSED_VAR(OS_Error_t err) = SysLoggerClient_init(sysLogger_Rpc_log);
+    Debug_ASSERT(err == OS_SUCCESS);
+}
+
+
+//------------------------------------------------------------------------------
+// if_StorageStats
+//------------------------------------------------------------------------------
+
+OS_Error_t
+stats_rpc_get(void)
+{
+    if (OS_Dataport_getSize(statsPort) < sizeof(StorageStats_t))
+    {
+        return OS_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    stats_mutex_lock();
+    stats.periodUs = (0 != resetUs) ? (getTimeUs() - resetUs) : 0;
+    memcpy(OS_Dataport_getBuf(statsPort), &stats, sizeof(stats));
+    stats_mutex_unlock();
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+stats_rpc_reset(void)
+{
+    stats_mutex_lock();
+    memset(&stats, 0, sizeof(stats));
+    resetUs = getTimeUs();
+    stats_mutex_unlock();
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+// if_OS_Storage
+//------------------------------------------------------------------------------
+
+OS_Error_t
+NONNULL_ALL
+storage_rpc_write(
+    off_t   offset,
+    size_t  size,
+    size_t* written)
+{
+    const uint64_t startUs = getTimeUs();
+    OS_Error_t err = OS_ERROR_INVALID_PARAMETER;
+
+    *written = 0;
+
+    if ((size <= OS_Dataport_getSize(clientPort))
+        && (size <= OS_Dataport_getSize(backendPort)))
+    {
+        memcpy(
+            OS_Dataport_getBuf(backendPort),
+            OS_Dataport_getBuf(clientPort),
+            size);
+
+        err = backend_rpc_write(offset, size, written);
+    }
+
+    account(OP_WRITE, *written, err, startUs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_read(
+    off_t   offset,
+    size_t  size,
+    size_t* read)
+{
+    const uint64_t startUs = getTimeUs();
+    OS_Error_t err = OS_ERROR_INVALID_PARAMETER;
+
+    *read = 0;
+
+    if ((size <= OS_Dataport_getSize(clientPort))
+        && (size <= OS_Dataport_getSize(backendPort)))
+    {
+        err = backend_rpc_read(offset, size, read);
+
+        memcpy(
+            OS_Dataport_getBuf(clientPort),
+            OS_Dataport_getBuf(backendPort),
+            *read);
+    }
+
+    account(OP_READ, *read, err, startUs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_erase(
+    off_t  offset,
+    off_t  size,
+    off_t* erased)
+{
+    const uint64_t startUs = getTimeUs();
+
+    *erased = 0;
+
+    const OS_Error_t err = backend_rpc_erase(offset, size, erased);
+
+    account(OP_ERASE, (*erased > 0) ? *erased : 0, err, startUs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getSize(
+    off_t* const size)
+{
+    const uint64_t startUs = getTimeUs();
+
+    const OS_Error_t err = backend_rpc_getSize(size);
+
+    account(OP_OTHER, 0, err, startUs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getBlockSize(
+    size_t* const blockSize)
+{
+    const uint64_t startUs = getTimeUs();
+
+    const OS_Error_t err = backend_rpc_getBlockSize(blockSize);
+
+    account(OP_OTHER, 0, err, startUs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getState(
+    uint32_t* flags)
+{
+    const uint64_t startUs = getTimeUs();
+
+    const OS_Error_t err = backend_rpc_getState(flags);
+
+    account(OP_OTHER, 0, err, startUs);
+
+    return err;
+}
@@ -0,0 +1,312 @@
+/*
+ * Storage trace recorder
+ *
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "OS_Error.h"
+#include "OS_Dataport.h"
+#include "TimeServer.h"
+#include "SysLoggerClient.h"
+#include "BootTiming.h"
+#include "StorageTrace.h"
+#include "lib_compiler/compiler.h"
+#include "lib_debug/Debug.h"
+
+#include <camkes.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+static const if_OS_Timer_t timer =
+    IF_OS_TIMER_ASSIGN(
+        timeServer_rpc,
+        timeServer_notify);
+
+static const OS_Dataport_t clientPort  = OS_DATAPORT_ASSIGN(storage_port);
+static const OS_Dataport_t backendPort = OS_DATAPORT_ASSIGN(backend_port);
+static const OS_Dataport_t tracePort   = OS_DATAPORT_ASSIGN(trace_port);
+
+static struct
+{
+    StorageTrace_Header_t*  header;
+    StorageTrace_Record_t*  records;
+    size_t                  maxRecords;
+    size_t                  numRecords;
+    uint64_t                startUs;
+    bool                    isTruncated;
+    bool                    isComplete;
+} ctx;
+
+
+//------------------------------------------------------------------------------
+static uint64_t
+getTimeUs(void)
+{
+    uint64_t now = 0;
+
+    const OS_Error_t err = TimeServer_getTime(
+                               &timer,
+                               TimeServer_PRECISION_USEC,
+                               &now);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("TimeServer_getTime() failed with %d", err);
+    }
+
+    return now;
+}
+
+
+//------------------------------------------------------------------------------
+static void
+completeTrace(
+    void* arg)
+{
+    trace_mutex_lock();
+
+    ctx.header->numRecords = ctx.numRecords;
+
+    // Make sure the reader sees all the records before the flag.
+    __sync_synchronize();
+    ctx.header->flags = StorageTrace_FLAG_COMPLETE
+                        | (ctx.isTruncated ? StorageTrace_FLAG_TRUNCATED : 0);
+    __sync_synchronize();
+
+    ctx.isComplete = true;
+
+    trace_mutex_unlock();
+
+    Debug_LOG_INFO(
+        "%s: trace completed with %zu records%s",
+        get_instance_name(),
+        ctx.numRecords,
+        ctx.isTruncated ? " (capacity reached)" : "");
+
+    trace_ready_emit();
+}
+
+
+//------------------------------------------------------------------------------
+static void
+recordRequest(
+    StorageTrace_Op_t op,
+    off_t             offset,
+    int64_t           size,
+    int64_t           result,
+    OS_Error_t        err,
+    uint64_t          startUs)
+{
+    const uint64_t endUs = getTimeUs();
+
+    trace_mutex_lock();
+
+    if (ctx.isComplete)
+    {
+        trace_mutex_unlock();
+        return;
+    }
+
+    if (ctx.numRecords >= ctx.maxRecords)
+    {
+        ctx.isTruncated = true;
+        trace_mutex_unlock();
+        return;
+    }
+
+    if (0 == ctx.numRecords)
+    {
+        ctx.startUs = startUs;
+        BootTiming_LOG("first request", startUs);
+    }
+
+    StorageTrace_Record_t* const rec = &ctx.records[ctx.numRecords++];
+
+    rec->timestampUs = (uint32_t)(startUs - ctx.startUs);
+    rec->durationUs  = (uint32_t)(endUs - startUs);
+    rec->offset      = offset;
+    rec->size        = size;
+    rec->result      = result;
+    rec->err         = err;
+    rec->op          = op;
+
+    trace_mutex_unlock();
+}
+
+
+//------------------------------------------------------------------------------
+void
+post_init(void)
+{
+    DECL_UNUSED_VAR(OS_Error_t err) = SysLoggerClient_init(sysLogger_Rpc_log);
+    Debug_ASSERT(err == OS_SUCCESS);
+
+    ctx.header     = OS_Dataport_getBuf(tracePort);
+    ctx.records    = StorageTrace_getRecords(ctx.header);
+    ctx.maxRecords = StorageTrace_MAX_RECORDS(OS_Dataport_getSize(tracePort));
+    if ((trace_max_records > 0) && (trace_max_records < ctx.maxRecords))
+    {
+        ctx.maxRecords = trace_max_records;
+    }
+
+    memset(ctx.header, 0, sizeof(*ctx.header));
+    ctx.header->magic      = StorageTrace_MAGIC;
+    ctx.header->version    = StorageTrace_VERSION;
+    ctx.header->recordSize = sizeof(StorageTrace_Record_t);
+
+    // The callback fires only once, which is all we need.
+    DECL_UNUSED_VAR(int rc) = client_done_reg_callback(completeTrace, NULL);
+    Debug_ASSERT(0 == rc);
+
+    Debug_LOG_DEBUG(
+        "%s: recording up to %zu requests",
+        get_instance_name(),
+        ctx.maxRecords);
+}
+
+
+//------------------------------------------------------------------------------
+// if_OS_Storage
+//------------------------------------------------------------------------------
+
+OS_Error_t
+NONNULL_ALL
+storage_rpc_write(
+    off_t   offset,
+    size_t  size,
+    size_t* written)
+{
+    const uint64_t startUs = getTimeUs();
+    OS_Error_t err = OS_ERROR_INVALID_PARAMETER;
+
+    *written = 0;
+
+    if ((size <= OS_Dataport_getSize(clientPort))
+        && (size <= OS_Dataport_getSize(backendPort)))
+    {
+        memcpy(
+            OS_Dataport_getBuf(backendPort),
+            OS_Dataport_getBuf(clientPort),
+            size);
+
+        err = backend_rpc_write(offset, size, written);
+    }
+
+    recordRequest(
+        StorageTrace_OP_WRITE, offset, size, *written, err, startUs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_read(
+    off_t   offset,
+    size_t  size,
+    size_t* read)
+{
+    const uint64_t startUs = getTimeUs();
+    OS_Error_t err = OS_ERROR_INVALID_PARAMETER;
+
+    *read = 0;
+
+    if ((size <= OS_Dataport_getSize(clientPort))
+        && (size <= OS_Dataport_getSize(backendPort)))
+    {
+        err = backend_rpc_read(offset, size, read);
+
+        memcpy(
+            OS_Dataport_getBuf(clientPort),
+            OS_Dataport_getBuf(backendPort),
+            *read);
+    }
+
+    recordRequest(
+        StorageTrace_OP_READ, offset, size, *read, err, startUs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_erase(
+    off_t  offset,
+    off_t  size,
+    off_t* erased)
+{
+    const uint64_t startUs = getTimeUs();
+
+    *erased = 0;
+
+    const OS_Error_t err = backend_rpc_erase(offset, size, erased);
+
+    recordRequest(
+        StorageTrace_OP_ERASE, offset, size, *erased, err, startUs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getSize(
+    off_t* const size)
+{
+    const uint64_t startUs = getTimeUs();
+
+    *size = 0;
+
+    const OS_Error_t err = backend_rpc_getSize(size);
+
+    recordRequest(
+        StorageTrace_OP_GET_SIZE, 0, 0, *size, err, startUs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getBlockSize(
+    size_t* const blockSize)
+{
+    const uint64_t startUs = getTimeUs();
+
+    *blockSize = 0;
+
+    const OS_Error_t err = backend_rpc_getBlockSize(blockSize);
+
+    recordRequest(
+        StorageTrace_OP_GET_BLOCK_SIZE, 0, 0, *blockSize, err, startUs);
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+NONNULL_ALL
+storage_rpc_getState(
+    uint32_t* flags)
+{
+    const uint64_t startUs = getTimeUs();
+
+    *flags = 0;
+
+    const OS_Error_t err = backend_rpc_getState(flags);
+
+    recordRequest(
+        StorageTrace_OP_GET_STATE, 0, 0, *flags, err, startUs);
+
+    return err;
+}
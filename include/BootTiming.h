@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Boot timing instrumentation
+ *
+ * Components log single points of time during boot in a common format: a
+ * tester when its run() is entered and when its first storage RPC returned,
+ * a proxy when it sees its first request and the latency shim when it has
+ * fetched the geometry of its backend. The boot timeline of all components
+ * can be extracted from the log by grepping for "[boot]". Times are taken from
+ * the TimeServer and thus relative to its start, which happens early during
+ * boot. All components using it are SysLogger clients, so the lines do not
+ * interleave with other log output.
+ */
+#pragma once
+
+#include "lib_debug/Debug.h"
+
+#include <camkes.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+
+#define BootTiming_LOG(_phase_, _timeUs_) \
+    Debug_LOG_INFO( \
+        "[boot] %s: %s at %" PRIu64 " us", \
+        get_instance_name(), \
+        (_phase_), \
+        (uint64_t)(_timeUs_))
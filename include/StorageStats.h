@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Statistics returned by if_StorageStats
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint64_t numWrites;
+    uint64_t numReads;
+    uint64_t numErases;
+    uint64_t bytesWritten;
+    uint64_t bytesRead;
+    uint64_t bytesErased;
+    uint64_t numErrors;     //!< requests not returning OS_SUCCESS
+    uint64_t busyUs;        //!< cumulative time spent serving requests
+    uint64_t maxLatencyUs;  //!< longest single request
+    uint64_t periodUs;      //!< time since the last reset
+} StorageStats_t;
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Binary format of the if_OS_Storage I/O traces
+ *
+ * A trace is written by the StorageTraceRecorder into a dedicated dataport and
+ * consists of a header followed by a flat array of fixed size records. The
+ * header is written last, so a reader may only rely on the records once the
+ * StorageTrace_FLAG_COMPLETE flag is set.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define StorageTrace_MAGIC          0x53545243 // "STRC"
+#define StorageTrace_VERSION        1
+
+#define StorageTrace_FLAG_COMPLETE  (1U << 0)
+// The recording stopped because the buffer was full.
+#define StorageTrace_FLAG_TRUNCATED (1U << 1)
+
+typedef enum
+{
+    StorageTrace_OP_WRITE = 0,
+    StorageTrace_OP_READ,
+    StorageTrace_OP_ERASE,
+    StorageTrace_OP_GET_SIZE,
+    StorageTrace_OP_GET_BLOCK_SIZE,
+    StorageTrace_OP_GET_STATE,
+
+    StorageTrace_OP_NUM
+} StorageTrace_Op_t;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t numRecords;
+    uint32_t flags;
+} StorageTrace_Header_t;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t timestampUs;   //!< relative to the first record of the trace
+    uint32_t durationUs;    //!< time the backend needed for the request
+    int64_t  offset;
+    int64_t  size;
+    int64_t  result;        //!< bytes processed or value returned by getXxx()
+    int32_t  err;           //!< OS_Error_t returned by the backend
+    uint8_t  op;            //!< StorageTrace_Op_t
+    uint8_t  reserved[3];
+} StorageTrace_Record_t;
+
+#define StorageTrace_MAX_RECORDS(_bufSize_) \
+    (((_bufSize_) - sizeof(StorageTrace_Header_t)) \
+     / sizeof(StorageTrace_Record_t))
+
+static inline StorageTrace_Record_t*
+StorageTrace_getRecords(
+    void* buf)
+{
+    return (StorageTrace_Record_t*)
+           ((uint8_t*)buf + sizeof(StorageTrace_Header_t));
+}
+
+static inline const char*
+StorageTrace_opName(
+    unsigned int op)
+{
+    static const char* const names[StorageTrace_OP_NUM] =
+    {
+        [StorageTrace_OP_WRITE]          = "write",
+        [StorageTrace_OP_READ]           = "read",
+        [StorageTrace_OP_ERASE]          = "erase",
+        [StorageTrace_OP_GET_SIZE]       = "getSize",
+        [StorageTrace_OP_GET_BLOCK_SIZE] = "getBlockSize",
+        [StorageTrace_OP_GET_STATE]      = "getState",
+    };
+
+    return (op < StorageTrace_OP_NUM) ? names[op] : "<invalid>";
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Deferred logging for code on a measurement path
+ *
+ * Every log message of a SysLogger client is an RPC. A log buffer instead
+ * formats the message into a slot of a fixed size ring of entries provided by
+ * the caller, which needs neither a lock nor an allocation and may be done by
+ * several threads at once. The messages are passed on to printf(), i.e. to the
+ * SysLogger, only when LogBuffer_flush() is called at a point where the time
+ * does not matter. Several messages are joined into one printf() if they fit.
+ *
+ * If the ring is full, new messages are dropped and counted instead of waiting
+ * for a flush. Only one thread may flush at a time.
+ */
+#pragma once
+
+#include "OS_Error.h"
+#include "lib_debug/Debug.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(LogBuffer_MSG_SIZE)
+#define LogBuffer_MSG_SIZE  256
+#endif
+
+typedef struct
+{
+    // Position of the entry in the ring it is free or filled for, see
+    // LogBuffer.c.
+    uint32_t seq;
+    char     msg[LogBuffer_MSG_SIZE];
+} LogBuffer_Entry_t;
+
+typedef struct
+{
+    LogBuffer_Entry_t*  entries;
+    uint32_t            numEntries;
+    uint32_t            head;
+    uint32_t            tail;
+    uint32_t            numDropped;
+} LogBuffer_t;
+
+// The messages are prefixed with their level like the ones of lib_debug and
+// filtered by the same Debug_Config_LOG_LEVEL. Like in lib_debug, messages
+// below that level are removed at compile time.
+#define LogBuffer_LOG(_self_, _name_, ...) \
+    LogBuffer_printf((_self_), _name_ ": " __VA_ARGS__)
+
+#define LogBuffer_LOG_NONE(_self_, ...) do { } while (0)
+
+#if (Debug_Config_LOG_LEVEL >= Debug_LOG_LEVEL_ERROR)
+#define LogBuffer_LOG_ERROR(_self_, ...) \
+    LogBuffer_LOG(_self_, "ERROR", __VA_ARGS__)
+#else
+#define LogBuffer_LOG_ERROR     LogBuffer_LOG_NONE
+#endif
+
+#if (Debug_Config_LOG_LEVEL >= Debug_LOG_LEVEL_WARNING)
+#define LogBuffer_LOG_WARNING(_self_, ...) \
+    LogBuffer_LOG(_self_, "WARNING", __VA_ARGS__)
+#else
+#define LogBuffer_LOG_WARNING   LogBuffer_LOG_NONE
+#endif
+
+#if (Debug_Config_LOG_LEVEL >= Debug_LOG_LEVEL_INFO)
+#define LogBuffer_LOG_INFO(_self_, ...) \
+    LogBuffer_LOG(_self_, "INFO", __VA_ARGS__)
+#else
+#define LogBuffer_LOG_INFO      LogBuffer_LOG_NONE
+#endif
+
+#if (Debug_Config_LOG_LEVEL >= Debug_LOG_LEVEL_DEBUG)
+#define LogBuffer_LOG_DEBUG(_self_, ...) \
+    LogBuffer_LOG(_self_, "DEBUG", __VA_ARGS__)
+#else
+#define LogBuffer_LOG_DEBUG     LogBuffer_LOG_NONE
+#endif
+
+/**
+ * @brief   Initializes a log buffer using the given entries.
+ *
+ * @param   numEntries  number of entries, must be a power of two
+ *
+ * @retval  OS_SUCCESS                  on success
+ * @retval  OS_ERROR_INVALID_PARAMETER  if a parameter is NULL or numEntries is
+ *                                      not a power of two
+ */
+OS_Error_t
+LogBuffer_init(
+    LogBuffer_t*        self,
+    LogBuffer_Entry_t*  entries,
+    size_t              numEntries);
+
+/**
+ * @brief   Formats a message into the next free entry.
+ *
+ * Messages longer than LogBuffer_MSG_SIZE are truncated, messages not fitting
+ * into the ring any more are dropped.
+ */
+void
+LogBuffer_printf(
+    LogBuffer_t*    self,
+    const char*     format,
+    ...)
+__attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief   Passes all buffered messages on to printf().
+ *
+ * Consecutive messages are joined into one printf() as long as they fit into
+ * batch, a message that does not fit alone is printed on its own.
+ *
+ * @param   batch       buffer the messages are joined in
+ * @param   batchSize   size of batch, at most the maximum message size of the
+ *                      SysLogger
+ *
+ * @return  the number of messages printed
+ */
+size_t
+LogBuffer_flush(
+    LogBuffer_t*    self,
+    char*           batch,
+    size_t          batchSize);
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "LogBuffer.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * The ring is a bounded multi-producer queue. Every entry has a sequence
+ * number telling its state for the position p of the ring it belongs to:
+ *
+ *   seq == p                   free, a producer may claim p
+ *   seq == p + 1               filled, the consumer may read it
+ *   seq == p + numEntries      read, free for the next round
+ *
+ * A producer claims p by advancing head with a compare-and-swap, so only the
+ * producer owning p writes to the entry. The consumer is the only one moving
+ * tail.
+ */
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+LogBuffer_init(
+    LogBuffer_t*        self,
+    LogBuffer_Entry_t*  entries,
+    size_t              numEntries)
+{
+    if ((NULL == self) || (NULL == entries) || (0 == numEntries)
+        || (0 != (numEntries & (numEntries - 1)))
+        || (numEntries > UINT32_MAX / 2))
+    {
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    memset(self, 0, sizeof(*self));
+    self->entries    = entries;
+    self->numEntries = numEntries;
+
+    for (uint32_t i = 0; i < self->numEntries; i++)
+    {
+        entries[i].seq    = i;
+        entries[i].msg[0] = '\0';
+    }
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+void
+LogBuffer_printf(
+    LogBuffer_t*    self,
+    const char*     format,
+    ...)
+{
+    if (NULL == self->entries)
+    {
+        return;
+    }
+
+    LogBuffer_Entry_t* entry;
+    uint32_t pos = __atomic_load_n(&self->head, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        entry = &self->entries[pos & (self->numEntries - 1)];
+
+        const uint32_t seq  = __atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE);
+        const int32_t  diff = (int32_t)(seq - pos);
+
+        if (0 == diff)
+        {
+            if (__atomic_compare_exchange_n(
+                    &self->head, &pos, pos + 1, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+            // pos has been updated by the failed compare-and-swap.
+        }
+        else if (diff < 0)
+        {
+            // The entry of the previous round has not been read yet.
+            __atomic_fetch_add(&self->numDropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        else
+        {
+            pos = __atomic_load_n(&self->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(entry->msg, sizeof(entry->msg), format, args);
+    va_end(args);
+
+    __atomic_store_n(&entry->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+
+//------------------------------------------------------------------------------
+static void
+printBatch(
+    char*   batch,
+    size_t* len)
+{
+    if (*len > 0)
+    {
+        printf("%s", batch);
+        *len = 0;
+        batch[0] = '\0';
+    }
+}
+
+
+//------------------------------------------------------------------------------
+size_t
+LogBuffer_flush(
+    LogBuffer_t*    self,
+    char*           batch,
+    size_t          batchSize)
+{
+    size_t numPrinted = 0;
+    size_t len        = 0;
+
+    if ((NULL == self->entries) || (0 == batchSize))
+    {
+        return 0;
+    }
+
+    batch[0] = '\0';
+
+    for (;;)
+    {
+        const uint32_t pos = self->tail;
+        LogBuffer_Entry_t* entry = &self->entries[pos & (self->numEntries - 1)];
+
+        if (__atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE) != (pos + 1))
+        {
+            // Empty, or the producer of the next entry is still writing it.
+            break;
+        }
+
+        const size_t msgLen = strnlen(entry->msg, sizeof(entry->msg));
+
+        // Every message ends with a newline in the batch.
+        if ((len + msgLen + 2) > batchSize)
+        {
+            printBatch(batch, &len);
+        }
+
+        if ((msgLen + 2) > batchSize)
+        {
+            printf("%.*s\n", (int)msgLen, entry->msg);
+        }
+        else
+        {
+            memcpy(&batch[len], entry->msg, msgLen);
+            len += msgLen;
+            batch[len++] = '\n';
+            batch[len]   = '\0';
+        }
+
+        __atomic_store_n(&entry->seq, pos + self->numEntries, __ATOMIC_RELEASE);
+        self->tail = pos + 1;
+        numPrinted++;
+    }
+
+    printBatch(batch, &len);
+
+    const uint32_t numDropped = __atomic_exchange_n(
+                                    &self->numDropped, 0, __ATOMIC_RELAXED);
+    if (numDropped > 0)
+    {
+        Debug_LOG_WARNING(
+            "%u log messages dropped, the log buffer was full", numDropped);
+    }
+
+    return numPrinted;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+/**
+ * @file
+ * @brief Byte granular access to an if_OS_Storage compatible storage
+ *
+ * The storage interface only transfers what fits into its dataport and many
+ * storages only accept block aligned requests. This library accepts arbitrary
+ * offsets and sizes, splits the transfers into dataport sized chunks and does
+ * a read-modify-write of partially covered blocks at the head and tail of a
+ * write. The old content of these blocks is read into the dataport before the
+ * new data is copied there, so a write never needs more write RPCs than the
+ * aligned equivalent, and at most two additional read RPCs.
+ *
+ * The storage geometry is queried once in StorageClient_init().
+ */
+#pragma once
+
+#include "OS_Error.h"
+#include "interfaces/if_OS_Storage.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+typedef struct
+{
+    uint64_t numWriteRpcs;
+    uint64_t numReadRpcs;
+    // Read RPCs done only for the read-modify-write of partial blocks.
+    uint64_t numRmwReadRpcs;
+    // Bytes transferred by the RPCs, including the padding to whole blocks.
+    uint64_t bytesWritten;
+    uint64_t bytesRead;
+} StorageClient_Counters_t;
+
+typedef struct
+{
+    const if_OS_Storage_t*   storage;
+    off_t                    size;
+    size_t                   blockSize;
+    // Largest block aligned transfer fitting into the dataport.
+    size_t                   chunkSize;
+    StorageClient_Counters_t counters;
+} StorageClient_t;
+
+/**
+ * @brief   Queries and caches the geometry of the storage.
+ *
+ * @retval  OS_SUCCESS                  on success
+ * @retval  OS_ERROR_INVALID_PARAMETER  if a parameter is NULL
+ * @retval  OS_ERROR_BUFFER_TOO_SMALL   if not even one block fits into the
+ *                                      dataport of the storage
+ * @return  the error of the storage if its geometry could not be queried
+ */
+OS_Error_t
+StorageClient_init(
+    StorageClient_t*        self,
+    const if_OS_Storage_t*  storage);
+
+/**
+ * @brief   Writes size bytes from buf to the storage at offset.
+ *
+ * @param   written set to the number of bytes of buf written, which is less
+ *                  than size only if an error occurred
+ *
+ * @retval  OS_SUCCESS                  on success
+ * @retval  OS_ERROR_INVALID_PARAMETER  if a parameter is NULL or the range is
+ *                                      not within the storage
+ * @return  the error of the storage otherwise
+ */
+OS_Error_t
+StorageClient_write(
+    StorageClient_t*    self,
+    off_t               offset,
+    const void*         buf,
+    size_t              size,
+    size_t*             written);
+
+/**
+ * @brief   Reads size bytes from the storage at offset into buf.
+ *
+ * @param   read    set to the number of bytes copied to buf, which is less
+ *                  than size only if an error occurred
+ *
+ * @retval  OS_SUCCESS                  on success
+ * @retval  OS_ERROR_INVALID_PARAMETER  if a parameter is NULL or the range is
+ *                                      not within the storage
+ * @return  the error of the storage otherwise
+ */
+OS_Error_t
+StorageClient_read(
+    StorageClient_t*    self,
+    off_t               offset,
+    void*               buf,
+    size_t              size,
+    size_t*             read);
+
+/**
+ * @brief   Rounds a value down to a multiple of the block size.
+ */
+off_t
+StorageClient_roundDown(
+    const StorageClient_t*  self,
+    off_t                   value);
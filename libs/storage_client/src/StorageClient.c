@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2024, HENSOLDT Cyber GmbH
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * For commercial licensing, contact: info.cyber@hensoldt.net
+ */
+
+#include "StorageClient.h"
+
+#include "lib_debug/Debug.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+//------------------------------------------------------------------------------
+static bool
+isValidRange(
+    const StorageClient_t*  self,
+    off_t                   offset,
+    size_t                  size)
+{
+    return (offset >= 0)
+           && (offset <= self->size)
+           && (size <= (uint64_t)(self->size - offset));
+}
+
+
+//------------------------------------------------------------------------------
+static off_t
+roundUp(
+    const StorageClient_t*  self,
+    off_t                   value)
+{
+    return StorageClient_roundDown(self, value + self->blockSize - 1);
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+writeRpc(
+    StorageClient_t*    self,
+    off_t               offset,
+    size_t              size)
+{
+    size_t written = 0;
+
+    const OS_Error_t err = self->storage->write(offset, size, &written);
+    self->counters.numWriteRpcs++;
+    self->counters.bytesWritten += written;
+
+    if ((OS_SUCCESS == err) && (written != size))
+    {
+        Debug_LOG_ERROR(
+            "Wrote only %zu of %zu bytes at %" PRIiMAX,
+            written, size, (intmax_t)offset);
+        return OS_ERROR_GENERIC;
+    }
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+static OS_Error_t
+readRpc(
+    StorageClient_t*    self,
+    off_t               offset,
+    size_t              size)
+{
+    size_t read = 0;
+
+    const OS_Error_t err = self->storage->read(offset, size, &read);
+    self->counters.numReadRpcs++;
+    self->counters.bytesRead += read;
+
+    if ((OS_SUCCESS == err) && (read != size))
+    {
+        Debug_LOG_ERROR(
+            "Read only %zu of %zu bytes at %" PRIiMAX,
+            read, size, (intmax_t)offset);
+        return OS_ERROR_GENERIC;
+    }
+
+    return err;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+StorageClient_init(
+    StorageClient_t*        self,
+    const if_OS_Storage_t*  storage)
+{
+    if ((NULL == self) || (NULL == storage))
+    {
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    memset(self, 0, sizeof(*self));
+    self->storage = storage;
+
+    OS_Error_t err = storage->getSize(&self->size);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("getSize() failed with %d", err);
+        return err;
+    }
+
+    err = storage->getBlockSize(&self->blockSize);
+    if (OS_SUCCESS != err)
+    {
+        Debug_LOG_ERROR("getBlockSize() failed with %d", err);
+        return err;
+    }
+
+    if (0 == self->blockSize)
+    {
+        Debug_LOG_ERROR("Block size of 0 reported");
+        return OS_ERROR_INVALID_STATE;
+    }
+
+    self->chunkSize = (OS_Dataport_getSize(storage->dataport) / self->blockSize)
+                      * self->blockSize;
+    if (0 == self->chunkSize)
+    {
+        Debug_LOG_ERROR(
+            "Dataport of %zu bytes can't hold a block of %zu bytes",
+            OS_Dataport_getSize(storage->dataport), self->blockSize);
+        return OS_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+StorageClient_write(
+    StorageClient_t*    self,
+    off_t               offset,
+    const void*         buf,
+    size_t              size,
+    size_t*             written)
+{
+    if ((NULL == self) || (NULL == buf) || (NULL == written))
+    {
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    *written = 0;
+
+    if (!isValidRange(self, offset, size))
+    {
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    if (0 == size)
+    {
+        return OS_SUCCESS;
+    }
+
+    uint8_t* const port  = OS_Dataport_getBuf(self->storage->dataport);
+    const off_t    end   = offset + size;
+    off_t          chunk = StorageClient_roundDown(self, offset);
+
+    while (chunk < end)
+    {
+        // The chunk covers whole blocks, only its first and last block may be
+        // covered partially by the data.
+        const off_t chunkEnd  = ((end - chunk) > (off_t)self->chunkSize)
+                                ? chunk + self->chunkSize
+                                : roundUp(self, end);
+        const off_t lastBlock = chunkEnd - self->blockSize;
+        const off_t dataStart = (offset > chunk) ? offset : chunk;
+        const off_t dataEnd   = (end < chunkEnd) ? end : chunkEnd;
+
+        const bool isFirstPartial = (dataStart > chunk);
+        const bool isLastPartial  = (dataEnd < chunkEnd);
+
+        OS_Error_t err = OS_SUCCESS;
+
+        // A read always goes to the start of the dataport, so the last block
+        // is read first and moved to its place in the chunk. If the chunk has
+        // only one block, reading the first block covers both cases.
+        if (isLastPartial && !(isFirstPartial && (lastBlock == chunk)))
+        {
+            err = readRpc(self, lastBlock, self->blockSize);
+            self->counters.numRmwReadRpcs++;
+            if (OS_SUCCESS != err)
+            {
+                return err;
+            }
+            memmove(&port[lastBlock - chunk], port, self->blockSize);
+        }
+
+        if (isFirstPartial)
+        {
+            err = readRpc(self, chunk, self->blockSize);
+            self->counters.numRmwReadRpcs++;
+            if (OS_SUCCESS != err)
+            {
+                return err;
+            }
+        }
+
+        memcpy(
+            &port[dataStart - chunk],
+            (const uint8_t*)buf + (dataStart - offset),
+            dataEnd - dataStart);
+
+        err = writeRpc(self, chunk, chunkEnd - chunk);
+        if (OS_SUCCESS != err)
+        {
+            return err;
+        }
+
+        *written += dataEnd - dataStart;
+        chunk = chunkEnd;
+    }
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+OS_Error_t
+StorageClient_read(
+    StorageClient_t*    self,
+    off_t               offset,
+    void*               buf,
+    size_t              size,
+    size_t*             read)
+{
+    if ((NULL == self) || (NULL == buf) || (NULL == read))
+    {
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    *read = 0;
+
+    if (!isValidRange(self, offset, size))
+    {
+        return OS_ERROR_INVALID_PARAMETER;
+    }
+
+    if (0 == size)
+    {
+        return OS_SUCCESS;
+    }
+
+    const uint8_t* const port  = OS_Dataport_getBuf(self->storage->dataport);
+    const off_t          end   = offset + size;
+    off_t                chunk = StorageClient_roundDown(self, offset);
+
+    while (chunk < end)
+    {
+        const off_t chunkEnd  = ((end - chunk) > (off_t)self->chunkSize)
+                                ? chunk + self->chunkSize
+                                : roundUp(self, end);
+        const off_t dataStart = (offset > chunk) ? offset : chunk;
+        const off_t dataEnd   = (end < chunkEnd) ? end : chunkEnd;
+
+        const OS_Error_t err = readRpc(self, chunk, chunkEnd - chunk);
+        if (OS_SUCCESS != err)
+        {
+            return err;
+        }
+
+        memcpy(
+            (uint8_t*)buf + (dataStart - offset),
+            &port[dataStart - chunk],
+            dataEnd - dataStart);
+
+        *read += dataEnd - dataStart;
+        chunk = chunkEnd;
+    }
+
+    return OS_SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------
+off_t
+StorageClient_roundDown(
+    const StorageClient_t*  self,
+    off_t                   value)
+{
+    return (value / (off_t)self->blockSize) * (off_t)self->blockSize;
+}
@@ -75,3 +75,152 @@
  *          test system.
  */
 #define TEST_STORAGE_MIN_SIZE   (2 * TEST_DATA_SIZE)
+
+//-----------------------------------------------------------------------------
+// Storage latency shim
+//-----------------------------------------------------------------------------
+
+// Rough model of a class 10 SD card in front of the RamDisk, all times in
+// microseconds, per-byte costs in nanoseconds per KiB. The values only need to
+// be in the right order of magnitude to make slow media effects visible.
+#define LATENCY_SHIM_READ_FIXED_US          100
+#define LATENCY_SHIM_READ_NS_PER_KIB        50000
+#define LATENCY_SHIM_WRITE_FIXED_US         250
+#define LATENCY_SHIM_WRITE_NS_PER_KIB       100000
+#define LATENCY_SHIM_ERASE_FIXED_US         1000
+#define LATENCY_SHIM_ERASE_NS_PER_KIB       2000
+#define LATENCY_SHIM_JITTER_MODE            2
+#define LATENCY_SHIM_JITTER_US              100
+#define LATENCY_SHIM_JITTER_SEED            42
+#define LATENCY_SHIM_STALL_EVERY_OPS        64
+#define LATENCY_SHIM_STALL_US               20000
+#define LATENCY_SHIM_ERASE_BLOCK_SIZE       (4 * 1024)
+#define LATENCY_SHIM_ERASE_BLOCK_PENALTY_US 500
+
+//-----------------------------------------------------------------------------
+// Storage trace capture and replay
+//-----------------------------------------------------------------------------
+
+// Size of the dataport shared between the StorageTraceRecorder and a replaying
+// StorageInterfaceTester, must be a multiple of the page size.
+#define STORAGE_TRACE_BUF_SIZE      (64 * 1024)
+
+// Maximum number of requests captured by the trace recorder in this test
+// system. The trace is completed when the recorded tester has finished, later
+// requests beyond this limit are forwarded but not recorded.
+#define STORAGE_TRACE_NUM_RECORDS   256
+
+// Replay modes of the StorageInterfaceTester, see the replay_mode attribute.
+// We can't make this an enum, because CAmkES does not understand enums.
+#define TESTER_REPLAY_OFF           0
+#define TESTER_REPLAY_TIMED         1
+#define TESTER_REPLAY_FAST          2
+
+//-----------------------------------------------------------------------------
+// Filesystem benchmark
+//-----------------------------------------------------------------------------
+
+// Size of the StorageServer partition the filesystems are created on.
+#define FS_BENCH_STORAGE_SIZE       (1 * 1024 * 1024)
+
+// Metadata-heavy workload: every file is created, appended to several times
+// with a "fsync" (close and re-open) after each append and finally deleted.
+#define FS_BENCH_NUM_FILES          32
+#define FS_BENCH_APPENDS_PER_FILE   4
+#define FS_BENCH_APPEND_SIZE        64
+
+// Streaming workload: one large file written and read back in chunks.
+#define FS_BENCH_STREAM_SIZE        (256 * 1024)
+#define FS_BENCH_STREAM_CHUNK_SIZE  4096
+
+//-----------------------------------------------------------------------------
+// Storage tester benchmarks
+//-----------------------------------------------------------------------------
+
+// Requests issued per measured point of the request size sweep.
+#define BENCH_SWEEP_REPETITIONS     32
+
+// A request size is considered to reach the full (multi-block) throughput if
+// it achieves this percentage of the best throughput measured in the sweep.
+#define BENCH_SWEEP_CROSSOVER_PCT   90
+
+// Amount of data moved per measured point of the dataport window sweep, the
+// number of RPCs needed for it is this size divided by the window size.
+#define BENCH_WINDOW_TOTAL_SIZE     (16 * 1024 * 1024)
+
+// Soak benchmark: mix of the operations in percent, the rest are reads.
+#define SOAK_WRITE_PCT              40
+#define SOAK_ERASE_PCT              10
+
+// Default length of a reporting window of the soak benchmark.
+#define SOAK_WINDOW_S               10
+
+// A soak window is flagged if its throughput or its 99th percentile latency
+// differs more than this percentage from the first window.
+#define SOAK_DRIFT_PCT              20
+
+// Duration of the soak run in this test system, real soak runs should last
+// hours.
+#define SOAK_TEST_DURATION_S        60
+
+// Messages the tester can buffer between two flushes of its log, must be a
+// power of two. Further messages are dropped.
+#define TESTER_LOG_NUM_ENTRIES      64
+
+// Counter sources of the instruction and cycle count benchmark, see the
+// bench_cycles attribute and tester_counters.h.
+#define TESTER_CYCLES_OFF           0
+#define TESTER_CYCLES_ICOUNT        1
+#define TESTER_CYCLES_PMU           2
+
+// Source used by the testers of this test system. TESTER_CYCLES_ICOUNT needs
+// QEMU to be run with "-icount shift=BENCH_CYCLES_ICOUNT_SHIFT",
+// TESTER_CYCLES_PMU a build with STORAGE_TESTER_PMU. Any source other than
+// TESTER_CYCLES_OFF builds the assembly of cycles.camkes.
+#if !defined(BENCH_CYCLES_SOURCE)
+#define BENCH_CYCLES_SOURCE         TESTER_CYCLES_OFF
+#endif
+#define BENCH_CYCLES_ICOUNT_SHIFT   0
+
+// Requests counted per operation and size.
+#define BENCH_CYCLES_REPETITIONS    32
+
+//-----------------------------------------------------------------------------
+// Large dataports
+//-----------------------------------------------------------------------------
+
+// Dataport size of the *_LargePort component types, must be a multiple of the
+// page size.
+#define STORAGE_LARGE_PORT_SIZE     (4 * 1024 * 1024)
+
+// Size of the in-tree StorageRamDisk, must not be smaller than the dataport.
+#define STORAGE_RAMDISK_SIZE        (8 * 1024 * 1024)
+
+// Granularity at which the StorageRamDisk tracks erased ranges instead of
+// filling them, the storage size must be a multiple of it.
+#define STORAGE_RAMDISK_ERASE_UNIT_SIZE 4096
+
+//-----------------------------------------------------------------------------
+// Storage concurrency benchmark
+//-----------------------------------------------------------------------------
+
+// Number of worker threads of the StorageConcurrencyTester, must match the
+// workers declared in StorageConcurrencyTester.camkes.
+#define CONCURRENCY_BENCH_NUM_WORKERS   4
+
+// Size of the StorageServer partition of every worker.
+#define CONCURRENCY_BENCH_STORAGE_SIZE  (64 * 1024)
+
+// Number of dataport sized writes, and then reads, every worker issues per
+// round.
+#define CONCURRENCY_BENCH_REQUESTS      256
+
+//-----------------------------------------------------------------------------
+// Storage layer benchmark
+//-----------------------------------------------------------------------------
+
+// Size of the storage on both paths of the StorageLayerBenchmark.
+#define LAYER_BENCH_STORAGE_SIZE        (64 * 1024)
+
+// Number of requests per operation and size issued to each path.
+#define LAYER_BENCH_REPETITIONS         64